@@ -98,6 +98,19 @@ void ControllerDataExporter::saveFile(std::string file)
     }
 }
 
+void ControllerDataExporter::recordFrameTimestamp(uint frame, double ms)
+{
+    _timestamps.record(frame, ms);
+}
+
+std::optional<double> ControllerDataExporter::frameTimestamp(int frame) const
+{
+    if (frame < 0) {
+        return std::nullopt;
+    }
+    return _timestamps.at(static_cast<size_t>(frame));
+}
+
 void ControllerDataExporter::createView()
 {
 
@@ -152,6 +165,8 @@ void ControllerDataExporter::receiveFinalizeExperiment()
         dynamic_cast<IModelDataExporter*>(getModel())->finalizeAndReInit();
         emitViewUpdate();
     }
+    // Frame numbers start over with the next media
+    _timestamps.clear();
 }
 
 void ControllerDataExporter::receiveReset()
@@ -162,6 +177,7 @@ void ControllerDataExporter::receiveReset()
         dynamic_cast<IModelDataExporter*>(getModel())->close();
         emitViewUpdate();
     }
+    _timestamps.clear();
 
     createModel();
 }
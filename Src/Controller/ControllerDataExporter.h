@@ -6,6 +6,8 @@
 #include "QPointer"
 #include "QThread"
 #include "Model/MediaPlayer.h"
+#include "util/FrameTimestamps.h"
+#include <optional>
 
 // POD class to bundle some infos
 struct SourceVideoMetadata
@@ -41,6 +43,13 @@ public:
     void loadFile(std::string file);
     void saveFile(std::string file);
 
+    /**
+     * Records the timestamp of a frame handed to the tracker, in
+     * milliseconds.
+     */
+    void                  recordFrameTimestamp(uint frame, double ms);
+    std::optional<double> frameTimestamp(int frame) const;
+
 Q_SIGNALS:
     void emitResetUndoStack();
     void emitViewUpdate();
@@ -64,4 +73,5 @@ private Q_SLOTS:
 private:
     IModelTrackedComponentFactory* _factory;
     bool                           _trialStarted = false;
+    FrameTimestamps                _timestamps;
 };
@@ -75,6 +75,17 @@ void ControllerMainWindow::loadCameraDevice(CameraConfiguration conf)
     dynamic_cast<MainWindow*>(m_View)->checkMediaGroupBox();
 }
 
+void ControllerMainWindow::loadStreamSource(std::string uri)
+{
+    Q_EMIT       emitOnLoadMedia(uri);
+    IController* ctr = m_BioTrackerContext->requestController(
+        ENUMS::CONTROLLERTYPE::PLAYER);
+    qobject_cast<ControllerPlayer*>(ctr)->loadStreamSource(uri);
+    Q_EMIT emitMediaLoaded(uri);
+
+    dynamic_cast<MainWindow*>(m_View)->checkMediaGroupBox();
+}
+
 void ControllerMainWindow::activeTracking()
 {
     IController* ctr = m_BioTrackerContext->requestController(
@@ -362,6 +373,8 @@ void ControllerMainWindow::connectControllerToController()
     // Load video as per CLI
     if (!_cfg->LoadVideo.isEmpty())
         loadVideo({_cfg->LoadVideo.toStdString().c_str()});
+    else if (!_cfg->LoadSource.isEmpty())
+        loadStreamSource(_cfg->LoadSource.toStdString());
 }
 
 void ControllerMainWindow::receiveCursorPosition(QPoint pos)
@@ -55,6 +55,11 @@ public:
      * of the MediaPlayer-Component.
      */
     void loadCameraDevice(CameraConfiguration conf);
+    /**
+     * Receives the URI of a stream source, e.g. "synthetic:?fps=100", and
+     * gives it to the ControllerPlayer class of the MediaPlayer-Component.
+     */
+    void loadStreamSource(std::string uri);
     /**
      * Receives a QStringListModel with the names of all currently loades
      * BioTracker Plugins from the ControllerPlugin class.
@@ -6,6 +6,7 @@
 #include "Controller/ControllerGraphicScene.h"
 #include "Controller/ControllerTrackedComponentCore.h"
 #include "Controller/ControllerCoreParameter.h"
+#include "Controller/ControllerDataExporter.h"
 
 #include <QGraphicsItem>
 #include <QToolButton>
@@ -40,6 +41,12 @@ void ControllerPlayer::loadCameraDevice(CameraConfiguration conf)
     emitPauseState(true);
 }
 
+void ControllerPlayer::loadStreamSource(std::string uri)
+{
+    qobject_cast<MediaPlayer*>(m_Model)->loadStreamSource(uri);
+    emitPauseState(true);
+}
+
 void ControllerPlayer::nextFrame()
 {
     qobject_cast<MediaPlayer*>(m_Model)->nextFrameCommand();
@@ -56,6 +63,12 @@ void ControllerPlayer::play()
     emitPauseState(false);
 }
 
+void ControllerPlayer::playBackwards()
+{
+    qobject_cast<MediaPlayer*>(m_Model)->playBackwardsCommand();
+    emitPauseState(false);
+}
+
 void ControllerPlayer::stop()
 {
     qobject_cast<MediaPlayer*>(m_Model)->stopCommand();
@@ -83,8 +96,20 @@ void ControllerPlayer::receiveRenderImage(cv::Mat img, QString name)
     ctrTextureObject->updateTexture(name, img);
 }
 
-void ControllerPlayer::receiveImageToTracker(cv::Mat mat, uint number)
+void ControllerPlayer::receiveImageToTracker(cv::Mat mat,
+                                             uint    number,
+                                             double  timestamp)
 {
+    // Recorded before tracking, the exporters write the frame once the
+    // plugin is done with it
+    IController* ctrExp = m_BioTrackerContext->requestController(
+        ENUMS::CONTROLLERTYPE::DATAEXPORT);
+    QPointer<ControllerDataExporter> ctrDataExporter =
+        qobject_cast<ControllerDataExporter*>(ctrExp);
+    if (ctrDataExporter && timestamp >= 0) {
+        ctrDataExporter->recordFrameTimestamp(number, timestamp);
+    }
+
     IController* ctr = m_BioTrackerContext->requestController(
         ENUMS::CONTROLLERTYPE::PLUGIN);
     QPointer<ControllerPlugin> ctrPlugin = qobject_cast<ControllerPlugin*>(
@@ -93,6 +118,25 @@ void ControllerPlayer::receiveImageToTracker(cv::Mat mat, uint number)
     ctrPlugin->sendCurrentFrameToPlugin(mat, number);
 }
 
+void ControllerPlayer::receiveBackground(cv::Mat background)
+{
+    IController* ctr = m_BioTrackerContext->requestController(
+        ENUMS::CONTROLLERTYPE::TEXTUREOBJECT);
+    QPointer<ControllerTextureObject> ctrTextureObject =
+        qobject_cast<ControllerTextureObject*>(ctr);
+    if (background.empty()) {
+        ctrTextureObject->removeCoreTexture("Background");
+    } else {
+        ctrTextureObject->setCoreTexture("Background", background);
+    }
+
+    IController* ctrP = m_BioTrackerContext->requestController(
+        ENUMS::CONTROLLERTYPE::PLUGIN);
+    QPointer<ControllerPlugin> ctrPlugin = qobject_cast<ControllerPlugin*>(
+        ctrP);
+    ctrPlugin->sendBackgroundToPlugin(background);
+}
+
 void ControllerPlayer::changeImageView(QString str)
 {
     IController* ctr = m_BioTrackerContext->requestController(
@@ -124,6 +168,11 @@ void ControllerPlayer::setTargetFps(double fps)
     return qobject_cast<MediaPlayer*>(m_Model)->setTargetFPS(fps);
 }
 
+void ControllerPlayer::setPixelFormat(PixelFormat format)
+{
+    qobject_cast<MediaPlayer*>(m_Model)->pixelFormatCommand(format);
+}
+
 QString ControllerPlayer::takeScreenshot()
 {
     IController* ctr = m_BioTrackerContext->requestController(
@@ -190,6 +239,10 @@ void ControllerPlayer::connectModelToController()
                      &MediaPlayer::trackCurrentImage,
                      this,
                      &ControllerPlayer::receiveImageToTracker);
+    QObject::connect(qobject_cast<MediaPlayer*>(m_Model),
+                     &MediaPlayer::backgroundChanged,
+                     this,
+                     &ControllerPlayer::receiveBackground);
     QObject::connect(this,
                      &ControllerPlayer::emitPauseState,
                      qobject_cast<MediaPlayer*>(m_Model),
@@ -39,6 +39,10 @@ public:
      * Hands over the camera device number to the IModel class MediaPlayer.
      */
     void loadCameraDevice(CameraConfiguration conf);
+    /**
+     * Hands over the URI of a stream source to the IModel class MediaPlayer.
+     */
+    void loadStreamSource(std::string uri);
 
     /**
      * Tells the MediaPlayer-Component to hand over the current cv::Mat and the
@@ -65,6 +69,10 @@ public:
      * Tells the IModel class MediaPlayer to start playing the ImageStream.
      */
     void play();
+    /**
+     * Tells the IModel class MediaPlayer to play the ImageStream backwards.
+     */
+    void playBackwards();
     /**
      * Tells the IModel class MediaPlayer to stop playing the ImageStream.
      */
@@ -89,6 +97,12 @@ public:
 
     void setTargetFps(double fps);
 
+    /**
+     * Tells the IModel class MediaPlayer in which format the BioTracker
+     * Plugin wants to receive the image frames.
+     */
+    void setPixelFormat(PixelFormat format);
+
     QString takeScreenshot();
 
     // IController interface
@@ -110,9 +124,16 @@ public Q_SLOTS:
     void receiveRenderImage(cv::Mat mat, QString name);
     /**
      * This SLOT receives a cv::Mat and its frame number and hands it over to
-     * the ControllerPlugin for Tracking in the BioTracker Plugin.
+     * the ControllerPlugin for Tracking in the BioTracker Plugin. The
+     * timestamp of the frame is handed to the ControllerDataExporter.
+     */
+    void receiveImageToTracker(cv::Mat mat, uint number, double timestamp);
+    /**
+     * Receives the background of the current video from the IModel class
+     * MediaPlayer and hands it to the TextureObject component and the
+     * Plugin.
      */
-    void receiveImageToTracker(cv::Mat mat, uint number);
+    void receiveBackground(cv::Mat background);
     /**
      * This SLOT receives a framenumber and hands it over to the
      * ControllerTrackedComponentCore for visualizing in the main app.
@@ -281,12 +281,25 @@ void ControllerPlugin::initPlugin()
 
     m_BioTrackerPlugin->moveToThread(m_TrackingThread);
 
+    // Let the player deliver frames in the format the tracker works on
+    QVariant format = pluginLoader->getPluginInstance()->property(
+        "inputPixelFormat");
+    IController* ctrPlayer = m_BioTrackerContext->requestController(
+        ENUMS::CONTROLLERTYPE::PLAYER);
+    qobject_cast<ControllerPlayer*>(ctrPlayer)->setPixelFormat(
+        pixelFormatFromString(format.isValid() ? format.toString()
+                                               : _cfg->InputPixelFormat));
+
     IController* ctrAreaDesc = m_BioTrackerContext->requestController(
         ENUMS::CONTROLLERTYPE::AREADESCRIPTOR);
     ControllerAreaDescriptor* ctAreaDesc =
         qobject_cast<ControllerAreaDescriptor*>(ctrAreaDesc);
     ctAreaDesc->triggerUpdateAreaDescriptor();
 
+    if (!m_background.empty()) {
+        sendBackgroundToPlugin(m_background);
+    }
+
     Q_EMIT signalCurrentFrameNumberToPlugin(m_currentFrameNumber);
 }
 
@@ -442,6 +455,25 @@ void ControllerPlugin::disconnectPlugin()
 {
 }
 
+void ControllerPlugin::sendBackgroundToPlugin(cv::Mat background)
+{
+    m_background = background;
+    if (!m_BioTrackerPlugin) {
+        return;
+    }
+
+    // Not part of IBioTrackerPlugin, so that existing Plugins keep working
+    const QMetaObject* meta = m_BioTrackerPlugin->metaObject();
+    if (meta->indexOfSlot(QMetaObject::normalizedSignature(
+            "receiveBackground(cv::Mat)")) < 0) {
+        return;
+    }
+    QMetaObject::invokeMethod(m_BioTrackerPlugin,
+                              "receiveBackground",
+                              Qt::QueuedConnection,
+                              Q_ARG(cv::Mat, background));
+}
+
 // first send all the commands currently in the command queue then the next
 // image can be sent
 void ControllerPlugin::sendCurrentFrameToPlugin(cv::Mat mat, uint number)
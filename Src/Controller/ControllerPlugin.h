@@ -81,6 +81,14 @@ public:
      */
     void sendCurrentFrameToPlugin(cv::Mat mat, uint number);
 
+    /**
+     * Hands the background of the current video to the Plugin, if it
+     * implements the optional SLOT receiveBackground(cv::Mat). It is handed
+     * again to Plugins loaded later. An empty background tells the Plugin
+     * to drop the one of the previous media.
+     */
+    void sendBackgroundToPlugin(cv::Mat background);
+
     void selectPlugin(QString str);
 
 signals:
@@ -210,6 +218,8 @@ private:
     bool m_paused = true;
 
     uint m_currentFrameNumber = 0;
+
+    cv::Mat m_background;
 };
 
 #endif // CONTROLLERPLUGIN_H
@@ -5,6 +5,7 @@
 #include "Controller/ControllerPlayer.h"
 #include "Model/MediaPlayerStateMachine/MediaPlayerStateMachine.h"
 #include "View/TextureObjectView.h"
+#include "View/GraphicsView.h"
 
 #include <QDebug>
 
@@ -48,6 +49,11 @@ void ControllerTextureObject::connectControllerToController()
     QGraphicsPixmapItem* item = dynamic_cast<QGraphicsPixmapItem*>(m_View);
 
     ctrGraphics->addTextureObject(item);
+
+    QObject::connect(dynamic_cast<GraphicsView*>(ctrGraphics->getView()),
+                     &GraphicsView::onZoomChanged,
+                     this,
+                     &ControllerTextureObject::receiveDisplayScale);
 }
 
 void ControllerTextureObject::setTextureNames(QVector<QString> names)
@@ -55,16 +61,44 @@ void ControllerTextureObject::setTextureNames(QVector<QString> names)
     changeTextureModel("Original");
 
     for (auto name : m_TextureViewNamesModel->stringList()) {
-        if (name != "Original") {
+        if (name != "Original" && !m_CoreTextures.contains(name)) {
             m_TextureObjects.remove(name);
         }
     }
 
-    m_TextureViewNamesModel->setStringList({"Original"});
+    m_TextureViewNamesModel->setStringList(QStringList("Original") +
+                                           m_CoreTextures.keys());
 
     for (auto name : names) {
+        if (!m_CoreTextures.contains(name)) {
+            createNewTextureObjectModel(name);
+        }
+    }
+}
+
+void ControllerTextureObject::setCoreTexture(QString name, cv::Mat img)
+{
+    if (!hasTexture(name)) {
         createNewTextureObjectModel(name);
     }
+    m_CoreTextures.insert(name, img);
+    m_TextureObjects.value(name)->set(img);
+}
+
+void ControllerTextureObject::removeCoreTexture(QString name)
+{
+    if (!m_CoreTextures.contains(name)) {
+        return;
+    }
+    if (m_Model == m_TextureObjects.value(name).data()) {
+        changeTextureModel("Original");
+    }
+    m_CoreTextures.remove(name);
+    m_TextureObjects.remove(name);
+
+    QStringList names = m_TextureViewNamesModel->stringList();
+    names.removeAll(name);
+    m_TextureViewNamesModel->setStringList(names);
 }
 
 void ControllerTextureObject::updateTexture(QString name, cv::Mat img)
@@ -89,6 +123,14 @@ void ControllerTextureObject::updateTextures(QMap<QString, cv::Mat> textures)
     }
 }
 
+void ControllerTextureObject::receiveDisplayScale(qreal scale)
+{
+    m_DisplayScale = scale;
+    for (auto texture : m_TextureObjects) {
+        texture->setDisplayScale(scale);
+    }
+}
+
 void ControllerTextureObject::createModel()
 {
     createNewTextureObjectModel(m_DefaultTextureName);
@@ -123,7 +165,9 @@ bool ControllerTextureObject::hasTexture(QString name)
 
 void ControllerTextureObject::createNewTextureObjectModel(QString name)
 {
-    m_TextureObjects.insert(name, new TextureObject(this, name));
+    TextureObject* texture = new TextureObject(this, name);
+    texture->setDisplayScale(m_DisplayScale);
+    m_TextureObjects.insert(name, texture);
 
     if (m_TextureViewNamesModel->insertRow(
             m_TextureViewNamesModel->rowCount())) {
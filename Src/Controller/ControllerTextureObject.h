@@ -55,10 +55,24 @@ public:
     QAbstractListModel* textureNamesModel();
     bool hasTexture(QString name);
 
+    /**
+     * Sets a texture provided by the core, e.g. the background of the
+     * video. Unlike the textures of the Plugin it is kept when the Plugin
+     * changes its texture names.
+     */
+    void setCoreTexture(QString name, cv::Mat img);
+
+    /**
+     * Removes a texture set with setCoreTexture, showing the original image
+     * if it was shown.
+     */
+    void removeCoreTexture(QString name);
+
 public Q_SLOTS:
     void setTextureNames(QVector<QString> names);
     void updateTexture(QString name, cv::Mat img);
     void updateTextures(QMap<QString, cv::Mat> textures);
+    void receiveDisplayScale(qreal scale);
 
 protected:
     void createModel() override;
@@ -71,8 +85,10 @@ private:
 
 private:
     QMap<QString, QPointer<TextureObject>> m_TextureObjects;
+    QMap<QString, cv::Mat>                 m_CoreTextures;
 
     QString m_DefaultTextureName = "Original";
+    qreal   m_DisplayScale       = 1;
 
     QPointer<QStringListModel> m_TextureViewNamesModel;
 };
@@ -58,6 +58,7 @@ public:
         STATE_PLAY,
         STATE_STEP_FORW,
         STATE_STEP_BACK,
+        STATE_PLAY_BACK,
         STATE_PAUSE,
         STATE_WAIT,
         STATE_GOTOFRAME
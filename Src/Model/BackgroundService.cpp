@@ -0,0 +1,89 @@
+#include "BackgroundService.h"
+#include "util/BackgroundModel.h"
+#include "util/VideoIndex.h"
+
+#include <QDebug>
+
+#include <chrono>
+
+BackgroundService::BackgroundService(QObject* parent, Config* cfg)
+: IModel(parent)
+, _cfg(cfg)
+{
+}
+
+BackgroundService::~BackgroundService()
+{
+    for (Job& job : _jobs) {
+        job.abort = true;
+    }
+    for (Job& job : _jobs) {
+        job.worker.join();
+    }
+}
+
+void BackgroundService::compute(const boost::filesystem::path& video)
+{
+    if (video == _video) {
+        return;
+    }
+    reset();
+    _video = video;
+
+    const int                     samples   = _cfg->BackgroundSamples;
+    const boost::filesystem::path directory = _cfg->BackgroundDir
+                                                  .toStdString();
+    // The seek index, if ImageStream3Video stored one, lets the samples be
+    // keyframes
+    std::shared_ptr<VideoIndex> index;
+    if (_cfg->VideoSeekIndex) {
+        index = VideoIndex::load(video,
+                                 _cfg->seekIndexDirectory().toStdString());
+    }
+
+    _jobs.emplace_back();
+    Job& job   = _jobs.back();
+    job.worker = std::thread([this, &job, video, samples, directory, index] {
+        auto model = BackgroundModel::load(video, samples, directory);
+        if (!model) {
+            const auto start = std::chrono::steady_clock::now();
+            model            = BackgroundModel::build(
+                video, index, samples, 0, job.abort);
+            if (model) {
+                model->save(directory);
+                qDebug()
+                    << "Background:" << samples << "samples in"
+                    << std::chrono::duration_cast<std::chrono::milliseconds>(
+                           std::chrono::steady_clock::now() - start)
+                           .count()
+                    << "ms";
+            }
+        }
+        if (model && !job.abort) {
+            Q_EMIT backgroundReady(QString::fromStdString(video.string()),
+                                   model->image());
+        }
+        job.done = true;
+    });
+}
+
+void BackgroundService::reset()
+{
+    if (!_jobs.empty()) {
+        _jobs.back().abort = true;
+    }
+    _video.clear();
+    collect();
+}
+
+void BackgroundService::collect()
+{
+    for (auto it = _jobs.begin(); it != _jobs.end();) {
+        if (it->done) {
+            it->worker.join();
+            it = _jobs.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Interfaces/IModel/IModel.h"
+#include "util/Config.h"
+
+#include <opencv2/opencv.hpp>
+#include <boost/filesystem.hpp>
+
+#include <atomic>
+#include <list>
+#include <thread>
+
+/**
+ * The BackgroundService is an IModel class which provides the median
+ * background of the current video (see BackgroundModel) to the trackers, so
+ * that they do not need to sample frames themselves. The model is computed
+ * on a worker thread, or loaded from the cache in Config::BackgroundDir.
+ */
+class BackgroundService : public IModel
+{
+    Q_OBJECT
+public:
+    BackgroundService(QObject* parent, Config* cfg);
+    ~BackgroundService();
+
+    /**
+     * Starts providing the background of video. The computation for the
+     * previous video is aborted, without waiting for it.
+     */
+    void compute(const boost::filesystem::path& video);
+
+    /**
+     * Aborts the computation, without waiting for it, and forgets the
+     * video.
+     */
+    void reset();
+
+Q_SIGNALS:
+    /**
+     * Emitted from the worker thread once the background of video is known.
+     */
+    void backgroundReady(QString video, cv::Mat background);
+
+private:
+    /**
+     * The computation for one video. Aborted ones finish in the background
+     * and are joined once they are done.
+     */
+    struct Job
+    {
+        std::thread       worker;
+        std::atomic<bool> abort{false};
+        std::atomic<bool> done{false};
+    };
+
+    /**
+     * Joins the jobs which are done.
+     */
+    void collect();
+
+    Config*                 _cfg;
+    boost::filesystem::path _video;
+    // The last one is the current job
+    std::list<Job>          _jobs;
+};
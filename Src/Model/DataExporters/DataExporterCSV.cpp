@@ -4,6 +4,8 @@
 #include <qdebug.h>
 #include <qfile.h>
 #include <qdatetime.h>
+#include <iomanip>
+#include <sstream>
 
 using namespace BioTrackerUtilsMisc; // split
 
@@ -51,7 +53,8 @@ std::string DataExporterCSV::getHeader(IModelTrackedComponent* comp, int cnt)
 {
     std::stringstream ss;
 
-    ss << "FRAME" << _separator << "MillisecsByFPS";
+    ss << "FRAME" << _separator << "MillisecsByFPS" << _separator
+       << "Millisecs";
     for (int c = 0; c < cnt; c++) {
         for (int i = 0; i < comp->metaObject()->propertyCount(); ++i) {
             if (comp->metaObject()->property(i).isStored(comp)) {
@@ -148,7 +151,9 @@ void DataExporterCSV::loadFile(std::string file)
 
     std::vector<std::string> strs;
     split(line, strs, _separator[0]);
-    int idcnt = (static_cast<int>(strs.size()) - 2) / headerEls;
+    // Files written before the Millisecs column have two global columns
+    const int globals = strs.size() > 2 && strs[2] == "Millisecs" ? 3 : 2;
+    int       idcnt   = (static_cast<int>(strs.size()) - globals) / headerEls;
 
     // Add data lines
     while (!ifs.eof()) {
@@ -159,17 +164,22 @@ void DataExporterCSV::loadFile(std::string file)
         if (strs.size() < 2)
             continue;
 
-        // First two entries are the "global header" (trajectory info, same for
+        // First entries are the "global header" (trajectory info, same for
         // all at current timeslice)
         int   frame     = atoi(strs[0].c_str());
         float frameById = atof(strs[1].c_str());
+        // Keep the time stamps, so that saving the tracks again does not
+        // lose them
+        if (globals == 3 && frame >= 0 && !strs[2].empty()) {
+            ctr->recordFrameTimestamp(frame, atof(strs[2].c_str()));
+        }
 
         // the current trajectory/element pair
         int                     curTrajCnt = 0;
         IModelTrackedComponent* comp = static_cast<IModelTrackedComponent*>(
             factory->getNewTrackedElement("0"));
 
-        for (int x = 2; x < strs.size(); x++) {
+        for (int x = globals; x < strs.size(); x++) {
             setProperty(comp, headerElsStr[curTrajCnt], strs[x].c_str());
 
             curTrajCnt++;
@@ -194,7 +204,8 @@ void DataExporterCSV::write(int idx)
     // TODO there is some duplicated code here
     _ofs << std::to_string(idx)
          << _separator +
-                std::to_string((long long) ((((double) idx) / _fps) * 1000));
+                std::to_string((long long) ((((double) idx) / _fps) * 1000))
+         << _separator << timestampColumn(idx);
 
     // Write single trajectory
     int trajNumber = 0;
@@ -217,6 +228,17 @@ void DataExporterCSV::write(int idx)
     _ofs << std::endl;
 }
 
+std::string DataExporterCSV::timestampColumn(int idx)
+{
+    std::optional<double> ms = _parent->frameTimestamp(idx);
+    if (!ms) {
+        return "";
+    }
+    std::ostringstream ss;
+    ss << std::fixed << std::setprecision(3) << *ms;
+    return ss.str();
+}
+
 void DataExporterCSV::finalizeAndReInit()
 {
 
@@ -287,7 +309,8 @@ void DataExporterCSV::writeAll(std::string f)
     for (int idx = 0; idx < max; idx++) {
 
         o << std::to_string(idx)
-          << _separator + std::to_string((((float) idx) / _fps) * 1000);
+          << _separator + std::to_string((((float) idx) / _fps) * 1000)
+          << _separator << timestampColumn(idx);
 
         int linecnt = 0;
         // i is the track number
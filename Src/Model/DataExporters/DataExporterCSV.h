@@ -42,6 +42,12 @@ private:
      */
     std::string writeTrackpoint(IModelTrackedPoint* e, int trajNumber);
 
+    /**
+     *  Timestamp of frame idx as recorded from the image stream (container
+     *  time stamp or capture time), empty if it is unknown
+     */
+    std::string timestampColumn(int idx);
+
     std::string _separator;
 
     /* finding the number of occurrences of a string in another strin
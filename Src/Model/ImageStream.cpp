@@ -3,10 +3,18 @@
 #include "util/stdext.h"
 #include <cassert>   // assert
 #include <stdexcept> // std::invalid_argument
+#include <atomic>
+#include <future>
 #include <chrono>
 #include <mutex>
 #include <thread>
 #include <limits>
+#include <map>
+#include <set>
+#include <algorithm>
+#include <random>
+#include <fstream>
+#include <cmath>
 
 #include <boost/circular_buffer.hpp>
 
@@ -15,9 +23,29 @@
 #include "Utility/misc.h"
 #include "View/CameraDevice.h"
 #include "util/VideoCoder.h"
+#include "util/ReadAheadDecoder.h"
+#include "util/ImagePrefetcher.h"
+#include "util/VideoIndex.h"
+#include "util/StridedRead.h"
+#include "util/RawFrameCache.h"
+#include "util/FramePool.h"
+#include "util/CameraAcquisition.h"
+#include "util/SharedFrameRing.h"
+#include "util/RawFrameReader.h"
+#include "util/FolderWatcher.h"
+#include "util/NetworkReceiver.h"
+#include "util/ReverseDecoder.h"
+#include "util/MotionIndex.h"
+#include "util/ThreadPool.h"
+#include "util/CameraProbe.h"
 
 #include "Controller/IControllerCfg.h"
 
+#include <QUrl>
+#include <QUrlQuery>
+#include <QStringList>
+#include <QThread>
+
 #if HAS_PYLON
     #include "util/camera/pylon.h"
     #include <opencv2/opencv.hpp>
@@ -33,10 +61,14 @@ namespace BioTracker
         : QObject(parent)
         , m_current_frame(cv::Mat(cv::Size(0, 0), CV_8UC3))
         , m_current_frame_number(0)
+        , m_decoder_in_sync(true)
         {
-            _cfg = cfg;
-            if (cfg)
+            _cfg           = cfg;
+            m_pixel_format = PixelFormat::BGR;
+            if (cfg) {
                 m_frame_stride = cfg->FrameStride;
+                m_pixel_format = pixelFormatFromString(cfg->InputPixelFormat);
+            }
         }
 
         size_t ImageStream::currentFrameNumber() const
@@ -56,10 +88,17 @@ namespace BioTracker
                 // skip update if frame number doesn't change
                 if (frame_number == this->currentFrameNumber()) {
                     return true;
+                } else if (this->takeCachedFrame(frame_number)) {
+                    m_current_frame_number = frame_number;
+                    return true;
                 } else {
                     const bool success = this->setFrameNumber_impl(
                         frame_number);
                     m_current_frame_number = frame_number;
+                    m_decoder_in_sync      = true;
+                    if (success) {
+                        this->cacheCurrentFrame(frame_number);
+                    }
                     return success;
                 }
             }
@@ -86,13 +125,29 @@ namespace BioTracker
             return this->currentFrame().empty();
         }
 
+        size_t ImageStream::nextFrameNumber()
+        {
+            return this->currentFrameNumber() + m_frame_stride;
+        }
+
         bool ImageStream::nextFrame()
         {
-            const size_t new_frame_number = this->currentFrameNumber() +
-                                            m_frame_stride;
+            const size_t new_frame_number = this->nextFrameNumber();
             if (new_frame_number < this->numFrames()) {
-                const bool success     = this->nextFrame_impl();
+                if (this->takeCachedFrame(new_frame_number)) {
+                    m_current_frame_number = new_frame_number;
+                    return true;
+                }
+                // the implementation continues from where it decoded last
+                const bool success = m_decoder_in_sync
+                                         ? this->nextFrame_impl()
+                                         : this->setFrameNumber_impl(
+                                               new_frame_number);
                 m_current_frame_number = new_frame_number;
+                m_decoder_in_sync      = true;
+                if (success) {
+                    this->cacheCurrentFrame(new_frame_number);
+                }
                 return success;
             } else {
                 this->clearImage();
@@ -100,12 +155,20 @@ namespace BioTracker
             }
         }
 
-        bool ImageStream::previousFrame()
+        bool ImageStream::previousFrame(bool playback)
         {
             if (this->currentFrameNumber() > 0) {
                 const size_t new_frame_numer = this->currentFrameNumber() - 1;
-                const bool   success         = this->previousFrame_impl();
-                m_current_frame_number       = new_frame_numer;
+                if (this->takeCachedFrame(new_frame_numer)) {
+                    m_current_frame_number = new_frame_numer;
+                    return true;
+                }
+                const bool success     = this->previousFrame_impl(playback);
+                m_current_frame_number = new_frame_numer;
+                m_decoder_in_sync      = true;
+                if (success) {
+                    this->cacheCurrentFrame(new_frame_numer);
+                }
                 return success;
             } else {
                 this->clearImage();
@@ -115,7 +178,79 @@ namespace BioTracker
 
         void ImageStream::set_current_frame(cv::Mat img)
         {
-            m_current_frame = img;
+            m_current_frame = convertPixelFormat(img, m_pixel_format);
+        }
+
+        void ImageStream::setPixelFormat(PixelFormat format)
+        {
+            if (format == m_pixel_format) {
+                return;
+            }
+            m_pixel_format = format;
+            if (m_frame_cache) {
+                m_frame_cache->clear();
+            }
+            this->pixelFormatChanged();
+            m_current_frame = convertPixelFormat(m_current_frame, format);
+        }
+
+        PixelFormat ImageStream::pixelFormat() const
+        {
+            return m_pixel_format;
+        }
+
+        void ImageStream::enableFrameCache()
+        {
+            if (_cfg && _cfg->FrameCacheMB > 0) {
+                m_frame_cache = std::make_unique<FrameCache>(
+                    static_cast<size_t>(_cfg->FrameCacheMB) * 1024 * 1024);
+            }
+        }
+
+        void ImageStream::clearFrameCache()
+        {
+            if (m_frame_cache) {
+                m_frame_cache->clear();
+            }
+            m_decoder_in_sync = true;
+        }
+
+        cv::MatAllocator* ImageStream::frameAllocator() const
+        {
+            if (!_cfg || _cfg->FramePoolMB <= 0) {
+                return nullptr;
+            }
+            return FramePool::shared(static_cast<size_t>(_cfg->FramePoolMB) *
+                                     1024 * 1024);
+        }
+
+        size_t ImageStream::frameCacheHits() const
+        {
+            return m_frame_cache ? m_frame_cache->hits() : 0;
+        }
+
+        size_t ImageStream::frameCacheMisses() const
+        {
+            return m_frame_cache ? m_frame_cache->misses() : 0;
+        }
+
+        bool ImageStream::takeCachedFrame(size_t frame_number)
+        {
+            cv::Mat frame;
+            if (!m_frame_cache || this->needsEveryFrame() ||
+                !m_frame_cache->get(frame_number, frame)) {
+                return false;
+            }
+            this->set_current_frame(frame);
+            m_decoder_in_sync = false;
+            return true;
+        }
+
+        void ImageStream::cacheCurrentFrame(size_t frame_number)
+        {
+            if (m_frame_cache) {
+                m_frame_cache->put(frame_number, m_current_frame);
+            }
         }
 
         void ImageStream::clearImage()
@@ -131,13 +266,22 @@ namespace BioTracker
             return this->setFrameNumber_impl(new_frame_number);
         }
 
-        bool ImageStream::previousFrame_impl()
+        bool ImageStream::previousFrame_impl(bool)
         {
             assert(this->currentFrameNumber() > 0);
             const size_t new_frame_number = this->currentFrameNumber() - 1;
             return this->setFrameNumber_impl(new_frame_number);
         }
 
+        void ImageStream::pixelFormatChanged()
+        {
+        }
+
+        bool ImageStream::needsEveryFrame() const
+        {
+            return false;
+        }
+
         bool ImageStream::hasNextInBatch()
         {
             return false;
@@ -152,7 +296,18 @@ namespace BioTracker
             return {};
         }
 
-        ImageStream::~ImageStream() = default;
+        double ImageStream::currentFrameTimestamp() const
+        {
+            return -1;
+        }
+
+        ImageStream::~ImageStream()
+        {
+            if (m_frame_cache) {
+                qDebug() << "Frame cache:" << m_frame_cache->hits()
+                         << "hits," << m_frame_cache->misses() << "misses";
+            }
+        }
 
         /*********************************************************/
 
@@ -184,55 +339,2020 @@ namespace BioTracker
         private:
             virtual bool setFrameNumber_impl(size_t) override
             {
-                return false;
+                return false;
+            }
+        };
+
+        /*********************************************************/
+
+        /**
+         * @return the numeric query item key of a stream source URI, fallback
+         * if it is missing or malformed.
+         */
+        static double queryParameter(const QUrlQuery& query,
+                                     const char*      key,
+                                     double           fallback)
+        {
+            bool         ok    = false;
+            const double value = query.queryItemValue(key).toDouble(&ok);
+            return ok ? value : fallback;
+        }
+
+        /**
+         * Renders moving blobs on a uniform background, to drive the pipeline
+         * at a controlled resolution and rate without any media. Blobs move
+         * along straight lines and bounce off the borders, so the position of
+         * every blob is known in closed form for any frame; the ground truth
+         * can be written to a CSV file.
+         */
+        class ImageStream3Synthetic : public ImageStream
+        {
+        public:
+            /**
+             * @throw source_open_error on invalid parameters
+             */
+            explicit ImageStream3Synthetic(Config* cfg, const QUrlQuery& query)
+            : ImageStream(0, cfg)
+            , m_width(
+                  static_cast<int>(queryParameter(query, "width", 1920)))
+            , m_height(
+                  static_cast<int>(queryParameter(query, "height", 1080)))
+            , m_fps(queryParameter(query, "fps", 25))
+            , m_frames(static_cast<size_t>(
+                  queryParameter(query, "frames", 10000)))
+            , m_noise(queryParameter(query, "noise", 0))
+            , m_paced(queryParameter(query, "paced", 1) != 0)
+            , m_format(query.hasQueryItem("format")
+                           ? pixelFormatFromString(
+                                 query.queryItemValue("format"))
+                           : PixelFormat::BGR)
+            {
+                const int    blobs  = static_cast<int>(
+                    queryParameter(query, "blobs", 10));
+                const double radius = queryParameter(query, "radius", 10);
+                const double speed  = queryParameter(query, "speed", 4);
+                const auto   seed   = static_cast<unsigned>(
+                    queryParameter(query, "seed", 1));
+                if (m_width <= 0 || m_height <= 0 || m_fps <= 0 ||
+                    m_frames == 0 || blobs < 0 || radius <= 0 ||
+                    m_noise < 0) {
+                    throw source_open_error(
+                        "Invalid synthetic stream parameters");
+                }
+
+                std::mt19937                           random(seed);
+                std::uniform_real_distribution<double> unit(0, 1);
+                for (int i = 0; i < blobs; i++) {
+                    const double angle = unit(random) * 2 * CV_PI;
+                    const double v     = speed * (0.5 + unit(random));
+                    Blob         blob;
+                    blob.x      = unit(random) * m_width;
+                    blob.y      = unit(random) * m_height;
+                    blob.vx     = v * std::cos(angle);
+                    blob.vy     = v * std::sin(angle);
+                    blob.radius = radius;
+                    m_blobs.push_back(blob);
+                }
+
+                // Noise is drawn once into a few frames which are cycled,
+                // drawing it per frame would dominate the measurements
+                if (m_noise > 0) {
+                    cv::RNG rng(seed);
+                    for (int i = 0; i < NoiseFrames; i++) {
+                        cv::Mat noise(m_height, m_width, frameType());
+                        rng.fill(noise,
+                                 cv::RNG::NORMAL,
+                                 cv::Scalar::all(noiseOffset()),
+                                 cv::Scalar::all(m_noise));
+                        m_noiseFrames.push_back(noise);
+                    }
+                }
+
+                const QString truth = query.queryItemValue("truth");
+                if (!truth.isEmpty()) {
+                    writeGroundTruth(truth.toStdString());
+                }
+
+                setTitle("Synthetic");
+                m_due = std::chrono::steady_clock::now();
+                render(0);
+            }
+            virtual GuiParam::MediaType type() const override
+            {
+                return GuiParam::MediaType::Video;
+            }
+            virtual size_t numFrames() const override
+            {
+                return m_frames;
+            }
+            virtual bool toggleRecord() override
+            {
+                return false;
+            }
+            virtual double fps() const override
+            {
+                return m_fps;
+            }
+            virtual std::string currentFilename() const override
+            {
+                return "Synthetic";
+            }
+            virtual double currentFrameTimestamp() const override
+            {
+                return m_current_frame_number * 1000 / m_fps;
+            }
+
+        private:
+            struct Blob
+            {
+                double x;
+                double y;
+                double vx;
+                double vy;
+                double radius;
+            };
+
+            static const int NoiseFrames = 8;
+            static const int Background  = 64;
+            static const int Foreground  = 192;
+
+            /**
+             * Position along an axis of length extent when moving from
+             * start, bouncing off both ends.
+             */
+            static double bounce(double position, double extent)
+            {
+                double folded = std::fmod(position, 2 * extent);
+                if (folded < 0) {
+                    folded += 2 * extent;
+                }
+                return folded <= extent ? folded : 2 * extent - folded;
+            }
+
+            cv::Point2d position(const Blob& blob, size_t frame) const
+            {
+                return cv::Point2d(bounce(blob.x + blob.vx * frame, m_width),
+                                   bounce(blob.y + blob.vy * frame, m_height));
+            }
+
+            int frameType() const
+            {
+                return m_format == PixelFormat::BGR ? CV_8UC3 : CV_8UC1;
+            }
+
+            double noiseOffset() const
+            {
+                return std::min(3 * m_noise, 255.0);
+            }
+
+            void writeGroundTruth(const std::string& filename) const
+            {
+                const std::string separator = _cfg->CsvSeperator.toStdString();
+                std::ofstream     out(filename);
+                out << "frame" << separator << "blob" << separator << "x"
+                    << separator << "y\n";
+                for (size_t frame = 0; frame < m_frames; frame++) {
+                    for (size_t i = 0; i < m_blobs.size(); i++) {
+                        const cv::Point2d p = position(m_blobs[i], frame);
+                        out << frame << separator << i << separator << p.x
+                            << separator << p.y << "\n";
+                    }
+                }
+                if (!out) {
+                    qWarning() << "Unable to write ground truth to"
+                               << QString::fromStdString(filename);
+                }
+            }
+
+            void render(size_t frame)
+            {
+                cv::Mat image(m_height,
+                              m_width,
+                              frameType(),
+                              cv::Scalar::all(Background));
+                for (const Blob& blob : m_blobs) {
+                    // Fixed point coordinates keep the subpixel position
+                    const int   shift = 4;
+                    cv::Point2d p     = position(blob, frame) * (1 << shift);
+                    cv::circle(image,
+                               cv::Point(cvRound(p.x), cvRound(p.y)),
+                               cvRound(blob.radius * (1 << shift)),
+                               cv::Scalar::all(Foreground),
+                               cv::FILLED,
+                               cv::LINE_AA,
+                               shift);
+                }
+                if (!m_noiseFrames.empty()) {
+                    cv::add(image,
+                            m_noiseFrames[frame % m_noiseFrames.size()],
+                            image);
+                    cv::subtract(image,
+                                 cv::Scalar::all(noiseOffset()),
+                                 image);
+                }
+                this->set_current_frame(image);
+            }
+
+            /**
+             * Waits until the next frame is due, unless the consumer is
+             * already late; lost time is not caught up.
+             */
+            void pace()
+            {
+                if (!m_paced) {
+                    return;
+                }
+                const auto interval = std::chrono::duration_cast<
+                    std::chrono::steady_clock::duration>(
+                    std::chrono::duration<double>(m_frame_stride / m_fps));
+                const auto now = std::chrono::steady_clock::now();
+                m_due += interval;
+                if (m_due > now) {
+                    std::this_thread::sleep_until(m_due);
+                } else {
+                    m_due = now;
+                }
+            }
+
+            virtual bool nextFrame_impl() override
+            {
+                pace();
+                render(m_current_frame_number + m_frame_stride);
+                return true;
+            }
+
+            virtual bool setFrameNumber_impl(size_t frame_number) override
+            {
+                m_due = std::chrono::steady_clock::now();
+                render(frame_number);
+                return true;
+            }
+
+            int                                   m_width;
+            int                                   m_height;
+            double                                m_fps;
+            size_t                                m_frames;
+            double                                m_noise;
+            bool                                  m_paced;
+            PixelFormat                           m_format;
+            std::vector<Blob>                     m_blobs;
+            std::vector<cv::Mat>                  m_noiseFrames;
+            std::chrono::steady_clock::time_point m_due;
+        };
+
+        /*********************************************************/
+
+        /**
+         * Frames published by another process into a SharedFrameRing. The
+         * frames are referenced in the shared memory, their slots stay pinned
+         * while any consumer holds them.
+         */
+        class ImageStream3SharedMemory : public ImageStream
+        {
+        public:
+            /**
+             * @throw source_open_error if there is no ring called name
+             */
+            explicit ImageStream3SharedMemory(Config*            cfg,
+                                              const std::string& name,
+                                              int                timeoutMs)
+            : ImageStream(0, cfg)
+            , m_ring(SharedFrameRing::attach(name))
+            , m_name(name)
+            , m_timeout(timeoutMs)
+            , m_firstTimestampNs(-1)
+            , m_timestamp(-1)
+            {
+                if (!m_ring) {
+                    throw source_open_error("No shared memory frame ring " +
+                                            name);
+                }
+                setTitle(name);
+
+                // Start with the newest frame, older ones are stale
+                const std::uint64_t published = m_ring->published();
+                m_nextSequence = published > 0 ? published - 1 : 0;
+                this->nextFrame_impl();
+            }
+            virtual GuiParam::MediaType type() const override
+            {
+                return GuiParam::MediaType::Camera;
+            }
+            virtual size_t numFrames() const override
+            {
+                return -1;
+            }
+            virtual bool toggleRecord() override
+            {
+                return false;
+            }
+            virtual double fps() const override
+            {
+                return m_ring->fps();
+            }
+            virtual std::string currentFilename() const override
+            {
+                return m_name;
+            }
+            virtual double currentFrameTimestamp() const override
+            {
+                return m_timestamp;
+            }
+
+        private:
+            virtual bool nextFrame_impl() override
+            {
+                // Of stride consecutive frames only the last one is used
+                const std::uint64_t wanted =
+                    m_nextSequence + m_frame_stride - 1;
+                const auto deadline = std::chrono::steady_clock::now() +
+                                      std::chrono::milliseconds(m_timeout);
+
+                std::uint64_t sequence = wanted;
+                cv::Mat       frame;
+                std::int64_t  timestampNs;
+                while (!m_ring->acquire(sequence, frame, timestampNs)) {
+                    if (std::chrono::steady_clock::now() > deadline) {
+                        qWarning() << "Shared memory: no frame from"
+                                   << QString::fromStdString(m_name);
+                        this->set_current_frame(cv::Mat());
+                        return false;
+                    }
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                    sequence = wanted;
+                }
+
+                if (sequence > wanted) {
+                    qWarning() << "Shared memory: lapped, skipped"
+                               << sequence - wanted << "frames";
+                }
+                m_nextSequence = sequence + 1;
+
+                if (m_firstTimestampNs < 0) {
+                    m_firstTimestampNs = timestampNs;
+                }
+                m_timestamp = (timestampNs - m_firstTimestampNs) / 1e6;
+
+                this->set_current_frame(frame);
+                return true;
+            }
+
+            virtual bool setFrameNumber_impl(size_t) override
+            {
+                return this->nextFrame_impl();
+            }
+
+            std::shared_ptr<SharedFrameRing> m_ring;
+            std::string                      m_name;
+            int                              m_timeout;
+            std::uint64_t                    m_nextSequence;
+            std::int64_t                     m_firstTimestampNs;
+            double                           m_timestamp;
+        };
+
+        /*********************************************************/
+
+        /**
+         * Raw frames of a fixed size read from stdin or a named pipe, e.g.
+         * from ffmpeg -f rawvideo -pix_fmt bgr24 -. The stream cannot seek,
+         * its length becomes known when the writer closes the pipe.
+         */
+        class ImageStream3Pipe : public ImageStream
+        {
+        public:
+            /**
+             * @param path "-" for stdin
+             * @throw source_open_error on invalid parameters
+             */
+            explicit ImageStream3Pipe(Config*            cfg,
+                                      const std::string& path,
+                                      const QUrlQuery&   query)
+            : ImageStream(0, cfg)
+            , m_path(path)
+            , m_fps(queryParameter(query, "fps", 25))
+            , m_timeout(
+                  static_cast<int>(queryParameter(query, "timeout", 5000)))
+            , m_frames(-1)
+            {
+                const int  width  = static_cast<int>(
+                    queryParameter(query, "width", 0));
+                const int  height = static_cast<int>(
+                    queryParameter(query, "height", 0));
+                const auto depth  = static_cast<size_t>(
+                    queryParameter(query, "buffer", 8));
+                const int  type   = frameType(query.queryItemValue("format"));
+                if (path.empty() || width <= 0 || height <= 0 ||
+                    m_fps <= 0 || depth == 0 || type < 0) {
+                    throw source_open_error("Invalid pipe stream parameters");
+                }
+
+                // The reader waits for the writer, frames are delivered by
+                // nextFrame() once they arrive
+                m_reader = std::make_unique<RawFrameReader>(
+                    path,
+                    cv::Size(width, height),
+                    type,
+                    depth,
+                    frameAllocator());
+                setTitle(path == "-" ? "stdin" : path);
+            }
+            virtual GuiParam::MediaType type() const override
+            {
+                return GuiParam::MediaType::Camera;
+            }
+            virtual size_t numFrames() const override
+            {
+                return m_frames;
+            }
+            virtual bool toggleRecord() override
+            {
+                return false;
+            }
+            virtual double fps() const override
+            {
+                return m_fps;
+            }
+            virtual std::string currentFilename() const override
+            {
+                return m_path;
+            }
+            virtual double currentFrameTimestamp() const override
+            {
+                return currentFrameNumber() * 1000 / m_fps;
+            }
+
+        private:
+            /**
+             * @return the OpenCV type of an ffmpeg rawvideo pixel format,
+             * bgr24 if empty, -1 if it is not supported.
+             */
+            static int frameType(const QString& format)
+            {
+                if (format.isEmpty() || format == "bgr24") {
+                    return CV_8UC3;
+                }
+                if (format == "bgra") {
+                    return CV_8UC4;
+                }
+                if (format == "gray") {
+                    return CV_8UC1;
+                }
+                return -1;
+            }
+
+            virtual bool nextFrame_impl() override
+            {
+                std::optional<cv::Mat> frame;
+                // Of stride consecutive frames only the last one is used
+                for (size_t i = 0; i < m_frame_stride; i++) {
+                    frame = m_reader->popFor(
+                        std::chrono::milliseconds(m_timeout));
+                    if (!frame) {
+                        if (m_reader->ended()) {
+                            // The length is known once the writer closed
+                            // the pipe, the player stops here
+                            m_frames = m_current_frame_number + 1;
+                        } else {
+                            qWarning() << "Pipe stream: no frame from"
+                                       << QString::fromStdString(m_path);
+                        }
+                        this->set_current_frame(cv::Mat());
+                        return false;
+                    }
+                }
+                this->set_current_frame(*frame);
+                return true;
+            }
+
+            virtual bool setFrameNumber_impl(size_t) override
+            {
+                // A pipe is read once
+                return false;
+            }
+
+            std::string                     m_path;
+            double                          m_fps;
+            int                             m_timeout;
+            size_t                          m_frames;
+            std::unique_ptr<RawFrameReader> m_reader;
+        };
+
+        /*********************************************************/
+
+        /**
+         * Images written into a folder while the stream is open, e.g. one
+         * per camera trigger. Files are decoded ahead by a FolderWatcher, the
+         * latency from the creation of a file to the delivery of its image
+         * is tracked.
+         */
+        class ImageStream3Folder : public ImageStream
+        {
+        public:
+            /**
+             * @throw source_open_error if the folder cannot be watched
+             */
+            explicit ImageStream3Folder(Config*            cfg,
+                                        const std::string& directory,
+                                        const QUrlQuery&   query)
+            : ImageStream(0, cfg)
+            , m_directory(directory)
+            , m_watcher(directory,
+                        static_cast<size_t>(std::max(
+                            1.0,
+                            queryParameter(query, "buffer", 16))))
+            , m_timeout(
+                  static_cast<int>(queryParameter(query, "timeout", 5000)))
+            , m_fps(queryParameter(query, "fps", 25))
+            , m_timestamp(-1)
+            , m_delivered(0)
+            , m_latencyMs(0)
+            , m_maxLatencyMs(0)
+            {
+                m_watcher.setImreadFlags(imreadFlags(m_pixel_format));
+                if (!m_watcher.start()) {
+                    throw source_open_error("Unable to watch folder " +
+                                            directory);
+                }
+                m_started = std::chrono::steady_clock::now();
+                setTitle(directory);
+            }
+            virtual ~ImageStream3Folder()
+            {
+                m_watcher.stop();
+                if (m_delivered > 0) {
+                    qDebug() << "Folder stream:" << m_delivered
+                             << "images, latency mean"
+                             << m_latencyMs / m_delivered << "ms, max"
+                             << m_maxLatencyMs << "ms,"
+                             << m_watcher.dropped() << "dropped";
+                }
+            }
+            virtual GuiParam::MediaType type() const override
+            {
+                return GuiParam::MediaType::Camera;
+            }
+            virtual size_t numFrames() const override
+            {
+                return -1;
+            }
+            virtual bool toggleRecord() override
+            {
+                return false;
+            }
+            virtual double fps() const override
+            {
+                return m_fps;
+            }
+            virtual std::string currentFilename() const override
+            {
+                return m_filename;
+            }
+            virtual double currentFrameTimestamp() const override
+            {
+                return m_timestamp;
+            }
+
+        private:
+            virtual bool nextFrame_impl() override
+            {
+                std::optional<WatchedImage> image;
+                // Of stride consecutive images only the last one is used
+                for (size_t i = 0; i < m_frame_stride; i++) {
+                    image = m_watcher.popFor(
+                        std::chrono::milliseconds(m_timeout));
+                    if (!image) {
+                        qWarning() << "Folder stream: no image in"
+                                   << QString::fromStdString(m_directory);
+                        this->set_current_frame(cv::Mat());
+                        return false;
+                    }
+                }
+
+                const double latency =
+                    std::chrono::duration<double, std::milli>(
+                        std::chrono::steady_clock::now() - image->created)
+                        .count();
+                m_delivered++;
+                m_latencyMs += latency;
+                m_maxLatencyMs = std::max(m_maxLatencyMs, latency);
+
+                m_timestamp = std::chrono::duration<double, std::milli>(
+                                  image->created - m_started)
+                                  .count();
+                m_filename  = image->path.string();
+                this->set_current_frame(image->image);
+                return true;
+            }
+
+            virtual bool setFrameNumber_impl(size_t) override
+            {
+                return this->nextFrame_impl();
+            }
+
+            virtual void pixelFormatChanged() override
+            {
+                m_watcher.setImreadFlags(imreadFlags(m_pixel_format));
+            }
+
+            std::string                           m_directory;
+            FolderWatcher                         m_watcher;
+            int                                   m_timeout;
+            double                                m_fps;
+            std::chrono::steady_clock::time_point m_started;
+            std::string                           m_filename;
+            double                                m_timestamp;
+            size_t                                m_delivered;
+            double                                m_latencyMs;
+            double                                m_maxLatencyMs;
+        };
+
+        /*********************************************************/
+
+        /**
+         * A live network stream, e.g. RTSP, UDP or HTTP MJPEG. Frames pass a
+         * JitterBuffer whose latency (Config::NetworkLatency) trades latency
+         * for smooth playout; lost connections are reestablished.
+         */
+        class ImageStream3Network : public ImageStream
+        {
+        public:
+            /**
+             * @throw source_open_error if no frame arrives within the timeout
+             */
+            explicit ImageStream3Network(Config* cfg, const std::string& url)
+            : ImageStream(0, cfg)
+            , m_url(url)
+            , m_receiver(url,
+                         static_cast<size_t>(std::max(1, cfg->NetworkBuffer)),
+                         std::chrono::milliseconds(
+                             std::max(0, cfg->NetworkLatency)))
+            , m_firstPts(-1)
+            , m_timestamp(-1)
+            {
+                m_receiver.start();
+                setTitle(url);
+                if (!this->nextFrame_impl()) {
+                    throw source_open_error("No frames from " + url);
+                }
+            }
+            virtual ~ImageStream3Network()
+            {
+                m_receiver.stop();
+                const JitterBuffer& buffer = m_receiver.buffer();
+                qDebug() << "Network stream:" << buffer.dropped()
+                         << "dropped," << buffer.late() << "late,"
+                         << buffer.duplicates() << "duplicate frames,"
+                         << m_receiver.reconnects() << "reconnects";
+            }
+            virtual GuiParam::MediaType type() const override
+            {
+                return GuiParam::MediaType::Camera;
+            }
+            virtual size_t numFrames() const override
+            {
+                return -1;
+            }
+            virtual bool toggleRecord() override
+            {
+                return false;
+            }
+            virtual double fps() const override
+            {
+                const double fps = m_receiver.fps();
+                return fps > 0 ? fps : 25;
+            }
+            virtual std::string currentFilename() const override
+            {
+                return m_url;
+            }
+            virtual double currentFrameTimestamp() const override
+            {
+                return m_timestamp;
+            }
+
+        private:
+            virtual bool nextFrame_impl() override
+            {
+                std::optional<NetworkFrame> frame;
+                // Of stride consecutive frames only the last one is used
+                for (size_t i = 0; i < m_frame_stride; i++) {
+                    frame = m_receiver.buffer().pop(
+                        std::chrono::milliseconds(Timeout));
+                    if (!frame) {
+                        qWarning() << "Network stream: no frame from"
+                                   << QString::fromStdString(m_url);
+                        this->set_current_frame(cv::Mat());
+                        return false;
+                    }
+                }
+
+                if (frame->pts >= 0) {
+                    // m_timestamp is relative to m_firstPts, the sender's
+                    // clock went back if the frame is before the last one
+                    const bool restarted =
+                        m_firstPts >= 0 &&
+                        frame->pts < m_firstPts + m_timestamp;
+                    if (m_firstPts < 0 || restarted) {
+                        // First frame or the sender started over
+                        m_firstPts = frame->pts;
+                    }
+                    m_timestamp = frame->pts - m_firstPts;
+                }
+                this->set_current_frame(frame->image);
+                return true;
+            }
+
+            virtual bool setFrameNumber_impl(size_t) override
+            {
+                return this->nextFrame_impl();
+            }
+
+            static constexpr int Timeout = 5000;
+
+            std::string     m_url;
+            NetworkReceiver m_receiver;
+            double          m_firstPts;
+            double          m_timestamp;
+        };
+
+        /*********************************************************/
+
+        /**
+         * Plays several sources (videos, cameras or other stream sources) in
+         * sync as a mosaic of equally sized tiles, so that a single tracker
+         * pass covers a whole rig of cameras. Every source is stepped on a
+         * thread of its own; a composite frame is complete when its slowest
+         * source is, so the decode latency of every source is logged.
+         *
+         * The sources follow one frame clock. With align=frame composite
+         * frame n shows frame n + offset of every source, with align=time
+         * the frame each source shows at n / fps seconds plus its offset in
+         * milliseconds, so sources of different frame rates line up. Live
+         * sources always show their newest frame, sources that have not
+         * started yet or have ended show a black tile.
+         *
+         * Tiles have the size of the first source and are laid out row by
+         * row in the order of the sources, so plugins find view i at column
+         * i % columns and row i / columns.
+         */
+        class ImageStream3Composite : public ImageStream
+        {
+        public:
+            /**
+             * @throw source_open_error if a source cannot be opened
+             */
+            explicit ImageStream3Composite(Config* cfg, const QUrlQuery& query)
+            : ImageStream(0, cfg)
+            , m_sourceCfg(*cfg)
+            , m_alignTime(query.queryItemValue("align") == "time")
+            , m_labels(queryParameter(query, "labels", 0) != 0)
+            , m_live(false)
+            , m_composed(0)
+            {
+                // Sources are stepped frame by frame along the shared clock
+                m_sourceCfg.FrameStride   = 1;
+                m_sourceCfg.SkimKeyframes = 0;
+                m_sourceCfg.SkimSeconds   = 0;
+                m_sourceCfg.MotionSkip    = 0;
+
+                const QStringList uris = query.allQueryItemValues(
+                    "source",
+                    QUrl::FullyDecoded);
+                const QStringList offsets = query.queryItemValue("offset")
+                                                .split(',');
+                if (uris.isEmpty()) {
+                    throw source_open_error("Composite stream without source");
+                }
+
+                // Sources are opened on their workers, cameras in parallel
+                QThread* owner = this->thread();
+                std::vector<std::future<std::shared_ptr<ImageStream>>> opened;
+                m_sources.resize(static_cast<size_t>(uris.size()));
+                for (int i = 0; i < uris.size(); i++) {
+                    Source& source = m_sources[static_cast<size_t>(i)];
+                    source.uri     = uris[i].toStdString();
+                    source.offset  = i < offsets.size() ? offsets[i].toDouble()
+                                                        : 0;
+                    source.worker  = std::make_unique<ThreadPool>(1);
+                    const QString uri = uris[i];
+                    opened.push_back(
+                        source.worker->submit([this, uri, owner] {
+                            auto stream = openSource(uri);
+                            stream->moveToThread(owner);
+                            return stream;
+                        }));
+                }
+                std::string error;
+                for (size_t i = 0; i < opened.size(); i++) {
+                    try {
+                        m_sources[i].stream = opened[i].get();
+                        m_sources[i].live   = m_sources[i].stream->type() ==
+                                            GuiParam::MediaType::Camera;
+                        m_live = m_live || m_sources[i].live;
+                    } catch (const source_open_error& e) {
+                        error = e.what();
+                    }
+                }
+                if (!error.empty()) {
+                    throw source_open_error(error);
+                }
+
+                ImageStream& first = *m_sources.front().stream;
+                m_tileSize         = first.currentFrame().size();
+                if (m_tileSize.area() == 0) {
+                    throw source_open_error("No frame from " +
+                                            m_sources.front().uri);
+                }
+                const double fps = queryParameter(query, "fps", first.fps());
+                m_fps            = fps > 0 ? fps : 25;
+
+                const int count = static_cast<int>(m_sources.size());
+                m_columns       = static_cast<int>(queryParameter(
+                    query,
+                    "columns",
+                    std::ceil(std::sqrt(static_cast<double>(count)))));
+                m_columns       = std::max(1, std::min(m_columns, count));
+                const int rows  = (count + m_columns - 1) / m_columns;
+                m_mosaicSize    = cv::Size(m_tileSize.width * m_columns,
+                                        m_tileSize.height * rows);
+
+                m_numFrames = m_live ? static_cast<size_t>(-1) : 0;
+                if (!m_live) {
+                    for (const Source& source : m_sources) {
+                        m_numFrames = std::max(m_numFrames, endFrame(source));
+                    }
+                }
+
+                setTitle("Composite_" + first.getTitle());
+                compose(0);
+            }
+            virtual ~ImageStream3Composite()
+            {
+                if (m_composed > 0) {
+                    report();
+                }
+            }
+            virtual GuiParam::MediaType type() const override
+            {
+                return m_live ? GuiParam::MediaType::Camera
+                              : GuiParam::MediaType::Video;
+            }
+            virtual size_t numFrames() const override
+            {
+                return m_numFrames;
+            }
+            virtual bool toggleRecord() override
+            {
+                return false;
+            }
+            virtual double fps() const override
+            {
+                return m_fps;
+            }
+            virtual std::string currentFilename() const override
+            {
+                return m_sources.front().stream->currentFilename();
+            }
+            virtual double currentFrameTimestamp() const override
+            {
+                if (m_live) {
+                    return -1;
+                }
+                return currentFrameNumber() * 1000 / m_fps;
+            }
+
+        private:
+            struct Source
+            {
+                std::string                  uri;
+                double                       offset = 0;
+                bool                         live   = false;
+                std::shared_ptr<ImageStream> stream;
+                // Decode latency in milliseconds
+                double last  = 0;
+                double total = 0;
+                double max   = 0;
+                // Declared last, so that it is destroyed first and waits for
+                // the task using the stream
+                std::unique_ptr<ThreadPool> worker;
+            };
+
+            virtual bool nextFrame_impl() override
+            {
+                return compose(currentFrameNumber() + m_frame_stride);
+            }
+
+            virtual bool setFrameNumber_impl(size_t frame_number) override
+            {
+                return compose(frame_number);
+            }
+
+            /**
+             * Opens a file path, camera:<index> (an OpenCV camera) or any
+             * other source make_ImageStream3Source() opens.
+             */
+            std::shared_ptr<ImageStream> openSource(const QString& uri)
+            {
+                const QUrl                   url(uri);
+                std::shared_ptr<ImageStream> stream;
+                if (url.scheme() == "camera") {
+                    bool      ok    = false;
+                    const int index = url.path().toInt(&ok);
+                    if (!ok) {
+                        throw source_open_error("Invalid camera " +
+                                                uri.toStdString());
+                    }
+                    stream = make_ImageStream3Camera(
+                        &m_sourceCfg,
+                        CameraConfiguration(
+                            CameraSelector{CameraType::OpenCV, index, ""},
+                            -1,
+                            -1,
+                            -1,
+                            false,
+                            "X264"));
+                } else if (url.isLocalFile() || url.scheme().size() < 2) {
+                    // One letter schemes are drive letters of Windows paths
+                    const QString file = url.isLocalFile() ? url.toLocalFile()
+                                                           : uri;
+                    stream             = make_ImageStream3Video(
+                        &m_sourceCfg,
+                        {boost::filesystem::path(file.toStdString())});
+                } else {
+                    stream = make_ImageStream3Source(&m_sourceCfg,
+                                                     uri.toStdString());
+                }
+                if (stream->type() == GuiParam::MediaType::NoMedia) {
+                    throw source_open_error("Unable to open source " +
+                                            uri.toStdString());
+                }
+                // Tiles are composed in BGR, the mosaic is converted once
+                stream->setPixelFormat(PixelFormat::BGR);
+                return stream;
+            }
+
+            /**
+             * @return the frame of source shown at composite frame number,
+             * negative before the source starts.
+             */
+            double sourceFrame(const Source& source, size_t number) const
+            {
+                if (!m_alignTime) {
+                    return number + source.offset;
+                }
+                const double time = number * 1000 / m_fps + source.offset;
+                return std::floor(time * source.stream->fps() / 1000 + 1e-6);
+            }
+
+            /**
+             * @return the composite frame after the last frame of source.
+             */
+            size_t endFrame(const Source& source) const
+            {
+                const double frames = source.stream->numFrames();
+                double       end;
+                if (!m_alignTime) {
+                    end = frames - source.offset;
+                } else {
+                    const double duration = frames * 1000 /
+                                            source.stream->fps();
+                    end = std::ceil((duration - source.offset) * m_fps / 1000);
+                }
+                return end > 0 ? static_cast<size_t>(end) : 0;
+            }
+
+            cv::Rect tileRect(size_t i) const
+            {
+                const int index = static_cast<int>(i);
+                return cv::Rect((index % m_columns) * m_tileSize.width,
+                                (index / m_columns) * m_tileSize.height,
+                                m_tileSize.width,
+                                m_tileSize.height);
+            }
+
+            /**
+             * Steps all sources to composite frame number in parallel.
+             * @return false if none of them has a frame.
+             */
+            bool compose(size_t number)
+            {
+                cv::Mat mosaic(m_mosaicSize, CV_8UC3, cv::Scalar::all(0));
+
+                std::vector<std::future<bool>> steps;
+                for (size_t i = 0; i < m_sources.size(); i++) {
+                    Source&       source = m_sources[i];
+                    const cv::Mat tile   = mosaic(tileRect(i));
+                    steps.push_back(source.worker->submit(
+                        [this, &source, i, number, tile] {
+                            return step(source, i, number, tile);
+                        }));
+                }
+                bool valid = false;
+                for (auto& result : steps) {
+                    valid = result.get() || valid;
+                }
+
+                if (++m_composed % ReportInterval == 0) {
+                    report();
+                }
+                this->set_current_frame(valid ? mosaic : cv::Mat());
+                return valid;
+            }
+
+            /**
+             * Brings source to composite frame number and copies its frame
+             * into tile, which stays black if the source has no such frame.
+             * Runs on the worker of the source.
+             */
+            bool step(Source& source, size_t i, size_t number, cv::Mat tile)
+            {
+                const auto start = std::chrono::steady_clock::now();
+
+                ImageStream& stream = *source.stream;
+                bool         valid;
+                if (source.live) {
+                    valid = stream.nextFrame();
+                } else {
+                    const double frame = sourceFrame(source, number);
+                    valid              = frame >= 0 &&
+                            frame < static_cast<double>(stream.numFrames()) &&
+                            seek(stream, static_cast<size_t>(frame));
+                }
+                const cv::Mat image = stream.currentFrame();
+                valid               = valid && !image.empty();
+                if (valid) {
+                    fitTile(image, tile);
+                }
+
+                const std::chrono::duration<double, std::milli> elapsed =
+                    std::chrono::steady_clock::now() - start;
+                source.last = elapsed.count();
+                source.total += source.last;
+                source.max = std::max(source.max, source.last);
+
+                if (m_labels) {
+                    cv::putText(tile,
+                                std::to_string(i) + ": " +
+                                    std::to_string(
+                                        static_cast<int>(source.last)) +
+                                    " ms",
+                                cv::Point(8, 24),
+                                cv::FONT_HERSHEY_SIMPLEX,
+                                0.8,
+                                cv::Scalar(0, 255, 255),
+                                2);
+                }
+                return valid;
+            }
+
+            /**
+             * Steps stream to frame, decoding the frames in between rather
+             * than seeking if they are only a few.
+             */
+            static bool seek(ImageStream& stream, size_t frame)
+            {
+                const size_t current = stream.currentFrameNumber();
+                if (frame <= current || frame - current > MaxCatchUp) {
+                    return stream.setFrameNumber(frame);
+                }
+                while (stream.currentFrameNumber() < frame) {
+                    if (!stream.nextFrame()) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+
+            static void fitTile(const cv::Mat& image, cv::Mat& tile)
+            {
+                cv::Mat bgr = image;
+                if (image.channels() == 1) {
+                    cv::cvtColor(image, bgr, cv::COLOR_GRAY2BGR);
+                } else if (image.channels() == 4) {
+                    cv::cvtColor(image, bgr, cv::COLOR_BGRA2BGR);
+                }
+                if (bgr.size() == tile.size()) {
+                    bgr.copyTo(tile);
+                } else {
+                    cv::resize(bgr, tile, tile.size(), 0, 0, cv::INTER_AREA);
+                }
+            }
+
+            /**
+             * Logs the decode latency of every source and names the slowest.
+             */
+            void report() const
+            {
+                QDebug        log     = qDebug();
+                const Source* slowest = nullptr;
+                log << "Composite stream decode ms (last/mean/max):";
+                for (size_t i = 0; i < m_sources.size(); i++) {
+                    const Source& source = m_sources[i];
+                    log << i << ":" << source.last << "/"
+                        << source.total / m_composed << "/" << source.max;
+                    if (!slowest || source.total > slowest->total) {
+                        slowest = &source;
+                    }
+                }
+                log << "slowest:" << QString::fromStdString(slowest->uri);
+            }
+
+            // Frames of a source decoded rather than seeking over them
+            static constexpr size_t MaxCatchUp = 8;
+            // Composite frames between logging the decode latencies
+            static constexpr size_t ReportInterval = 500;
+
+            Config              m_sourceCfg;
+            const bool          m_alignTime;
+            const bool          m_labels;
+            bool                m_live;
+            double              m_fps;
+            int                 m_columns;
+            cv::Size            m_tileSize;
+            cv::Size            m_mosaicSize;
+            size_t              m_numFrames;
+            size_t              m_composed;
+            std::vector<Source> m_sources;
+        };
+
+        /*********************************************************/
+
+        class ImageStream3Pictures : public ImageStream
+        {
+        public:
+            explicit ImageStream3Pictures(
+                Config*                              cfg,
+                std::vector<boost::filesystem::path> picture_files)
+            : ImageStream(0, cfg)
+            , m_picture_files(std::move(picture_files))
+            , m_currentFrame(0)
+            {
+
+                // Grab the codec from config file
+                double fps = _cfg->RecordFPS;
+                if (fps > 0) {
+                    m_fps = fps;
+                } else {
+                    m_fps = 1;
+                }
+
+                enableFrameCache();
+                if (_cfg->PicturePrefetch > 0) {
+                    m_prefetcher = std::make_unique<ImagePrefetcher>(
+                        m_picture_files,
+                        static_cast<size_t>(_cfg->PicturePrefetch),
+                        static_cast<size_t>(
+                            std::max(0, _cfg->PrefetchThreads)));
+                    m_prefetcher->setImreadFlags(imreadFlags(m_pixel_format));
+                }
+
+                // load first image
+                m_recording = false;
+                if (this->numFrames() > 0) {
+                    this->setFrameNumber_impl(0);
+                    m_w    = currentFrame().size().width;
+                    m_h    = currentFrame().size().height;
+                    vCoder = std::make_shared<VideoCoder>(m_fps, _cfg);
+                }
+            }
+            virtual GuiParam::MediaType type() const override
+            {
+                return GuiParam::MediaType::Images;
+            }
+            virtual size_t numFrames() const override
+            {
+                return m_picture_files.size();
+            }
+            virtual bool toggleRecord() override
+            {
+                if (this->numFrames() <= 0) {
+                    return false;
+                }
+                m_recording = vCoder->toggle(m_w, m_h, m_fps);
+
+                return m_recording;
+            }
+            virtual double fps() const override
+            {
+                return m_fps;
+            }
+            virtual std::string currentFilename() const override
+            {
+                assert(currentFrameNumber() < m_picture_files.size());
+                return m_picture_files[currentFrameNumber()].string();
+            }
+
+        private:
+            virtual bool nextFrame_impl() override
+            {
+                m_currentFrame += static_cast<int>(m_frame_stride);
+                if (this->numFrames() > m_currentFrame) {
+
+                    auto new_frame = loadPicture(m_currentFrame);
+                    this->set_current_frame(new_frame);
+                    if (m_recording) {
+                        if (vCoder)
+                            vCoder->add(new_frame);
+                    }
+                    return true;
+                }
+                return false;
+            }
+
+            virtual bool setFrameNumber_impl(size_t frame_number) override
+            {
+                auto new_frame = loadPicture(frame_number);
+                this->set_current_frame(new_frame);
+                m_currentFrame = static_cast<int>(frame_number);
+                if (m_recording) {
+                    if (vCoder)
+                        vCoder->add(new_frame);
+                }
+                return !new_frame.empty();
+            }
+
+            virtual void pixelFormatChanged() override
+            {
+                if (m_prefetcher) {
+                    m_prefetcher->setImreadFlags(imreadFlags(m_pixel_format));
+                }
+            }
+
+            virtual bool needsEveryFrame() const override
+            {
+                return m_recording;
+            }
+
+            cv::Mat loadPicture(size_t index)
+            {
+                if (m_prefetcher) {
+                    return m_prefetcher->get(index, m_frame_stride);
+                }
+                return cv::imread(m_picture_files[index].string(),
+                                  imreadFlags(m_pixel_format));
+            }
+
+            std::vector<boost::filesystem::path> m_picture_files;
+            std::unique_ptr<ImagePrefetcher>     m_prefetcher;
+            std::shared_ptr<VideoCoder>          vCoder;
+            double                               m_w;
+            double                               m_h;
+            bool                                 m_recording;
+            int                                  m_currentFrame;
+            double                               m_fps;
+        };
+
+        /*********************************************************/
+
+        class ImageStream3Video : public ImageStream
+        {
+        public:
+            /**
+             * @throw file_not_found when the file does not exists
+             * @throw video_open_error when there is an error with the video
+             * @brief ImageStreamVideo
+             * @param filename path to the file
+             */
+            explicit ImageStream3Video(
+                Config*                                     cfg,
+                const std::vector<boost::filesystem::path>& files)
+            : ImageStream(0, cfg)
+            {
+                if (_cfg->VideoReadAhead > 0) {
+                    m_readAhead = std::make_unique<ReadAheadDecoder>(
+                        static_cast<size_t>(_cfg->VideoReadAhead));
+                }
+                enableFrameCache();
+                openMedia(files);
+            }
+            ~ImageStream3Video()
+            {
+                stopIndexScan();
+            }
+            virtual GuiParam::MediaType type() const override
+            {
+                return GuiParam::MediaType::Video;
+            }
+            virtual size_t numFrames() const override
+            {
+                return m_num_frames;
+            }
+            virtual bool toggleRecord() override
+            {
+                if (!m_capture->isOpened()) {
+                    return false;
+                }
+                m_recording = vCoder->toggle(m_w, m_h, m_fps);
+
+                return m_recording;
+            }
+            virtual double fps() const override
+            {
+                return m_fps;
+            }
+            virtual std::string currentFilename() const override
+            {
+                return m_fileName;
+            }
+            virtual double currentFrameTimestamp() const override
+            {
+                // The container time stamps are known once the video is
+                // indexed, which also handles variable frame rates
+                if (m_index && currentFrameNumber() < m_index->frameCount()) {
+                    return m_index->timestamp(currentFrameNumber());
+                }
+                // Until then the capture knows the time stamp of the frame
+                // it decoded last, unless the read-ahead thread owns it
+                const bool decodedLast =
+                    m_nextDecodeFrame == currentFrameNumber() + 1 &&
+                    !(m_readAhead && m_readAhead->running());
+                if (decodedLast) {
+                    const double msec = m_capture->get(cv::CAP_PROP_POS_MSEC);
+                    if (msec >= 0) {
+                        return msec;
+                    }
+                }
+                return currentFrameNumber() * 1000 / m_fps;
+            }
+
+            virtual bool hasNextInBatch() override
+            {
+                return !(m_batch.empty());
+            }
+
+            virtual void stepToNextInBatch() override
+            {
+                if (m_batch.empty()) {
+                    throw video_open_error("batch is empty");
+                }
+                openMedia(m_batch);
+            }
+
+            virtual std::vector<std::string> getBatchItems() override
+            {
+                std::vector<std::string> batchItems;
+                for (auto x : m_batch) {
+                    batchItems.push_back(x.string());
+                }
+                return batchItems;
+            }
+
+        private:
+            void openMedia(std::vector<boost::filesystem::path> files)
+            {
+                // The decoder thread must release the capture before it is
+                // reopened
+                if (m_readAhead) {
+                    m_readAhead->stop();
+                }
+                stopIndexScan();
+                m_rawCacheWriter.reset();
+                m_index.reset();
+                m_motion.reset();
+                m_reverse.reset();
+                m_reverseIndex.reset();
+                m_reversed = false;
+                clearFrameCache();
+
+                // Take over the next batch item if it was opened in advance
+                std::unique_ptr<OpenedVideo> video;
+                if (m_nextInBatch.valid()) {
+                    video = m_nextInBatch.get();
+                    if (video->file != files.front()) {
+                        video.reset();
+                    }
+                }
+                if (!video) {
+                    video = openVideo(
+                        files.front(),
+                        _cfg->seekIndexDirectory().toStdString());
+                }
+
+                m_capture    = std::move(video->capture);
+                m_num_frames = static_cast<size_t>(
+                    m_capture->get(cv::CAP_PROP_FRAME_COUNT));
+                m_fps      = m_capture->get(cv::CAP_PROP_FPS);
+                m_fileName = files.front().string();
+
+                if (!boost::filesystem::exists(files.front())) {
+                    throw file_not_found("Could not find file " +
+                                         files.front().string());
+                }
+                if (!m_capture->isOpened()) {
+                    throw video_open_error(":(");
+                }
+
+                m_batch = files;
+                m_batch.erase(m_batch.begin(), m_batch.begin() + 1);
+
+                // Grab the fps from config file
+                double fps = _cfg->RecordFPS;
+                if (fps != -1) {
+                    m_fps = fps;
+                }
+
+                m_w         = m_capture->get(cv::CAP_PROP_FRAME_WIDTH);
+                m_h         = m_capture->get(cv::CAP_PROP_FRAME_HEIGHT);
+                m_recording = false;
+                vCoder      = std::make_shared<VideoCoder>(m_fps, _cfg);
+
+                m_index = std::move(video->index);
+                if (m_index) {
+                    m_num_frames = m_index->frameCount();
+                }
+                if ((!m_index && _cfg->VideoSeekIndex) || _cfg->MotionSkip) {
+                    startIndexScan(files.front());
+                }
+                if (_cfg->RawCacheMB > 0) {
+                    startRawCache(files.front(), video->firstFrame);
+                }
+
+                // the first image was decoded while opening
+                m_nextDecodeFrame = video->firstFrame.empty() ? UnknownPosition
+                                                              : 1;
+                showFrame(video->firstFrame);
+
+                m_current_frame_number = 0;
+                m_positionUnverified   = false;
+
+                if (_cfg->BatchPreOpen && !m_batch.empty()) {
+                    m_nextInBatch = std::async(std::launch::async,
+                                               &ImageStream3Video::openVideo,
+                                               m_batch.front(),
+                                               _cfg->seekIndexDirectory()
+                                                   .toStdString());
+                }
+            }
+
+            /**
+             * A video file opened ahead of time, with its first frame
+             * decoded and its seek index loaded.
+             */
+            struct OpenedVideo
+            {
+                boost::filesystem::path           file;
+                std::unique_ptr<cv::VideoCapture> capture;
+                cv::Mat                           firstFrame;
+                std::shared_ptr<VideoIndex>       index;
+            };
+
+            /**
+             * Opens file and decodes its first frame. Runs on a background
+             * thread for the next batch item, so it must not touch the
+             * stream.
+             * @param indexDirectory where seek indices are stored, empty to
+             * not use one
+             */
+            static std::unique_ptr<OpenedVideo> openVideo(
+                const boost::filesystem::path& file,
+                const boost::filesystem::path& indexDirectory)
+            {
+                auto video     = std::make_unique<OpenedVideo>();
+                video->file    = file;
+                video->capture = std::make_unique<cv::VideoCapture>(
+                    file.string());
+                if (video->capture->isOpened()) {
+                    video->capture->read(video->firstFrame);
+                }
+                if (!indexDirectory.empty()) {
+                    video->index = VideoIndex::load(file, indexDirectory);
+                }
+                return video;
+            }
+
+            virtual bool nextFrame_impl() override
+            {
+                // The capture is still where forward playback left it
+                if (m_reversed) {
+                    return seekFrame(nextFrameNumber());
+                }
+                adoptIndex();
+                // Locates the capture with the index again
+                if (m_index && m_nextDecodeFrame == UnknownPosition) {
+                    return seekFrame(nextFrameNumber());
+                }
+                if (skipsFrames()) {
+                    const size_t next = nextFrameNumber();
+                    if (next != currentFrameNumber() + m_frame_stride) {
+                        return seekFrame(next);
+                    }
+                }
+
+                const size_t decoded = m_nextDecodeFrame + m_frame_stride - 1;
+                cv::Mat      new_frame;
+                new_frame.allocator = frameAllocator();
+                if (m_readAhead) {
+                    if (!m_readAhead->running()) {
+                        m_readAhead->start(m_capture.get(),
+                                           m_frame_stride,
+                                           frameAllocator());
+                    }
+                    new_frame = m_readAhead->pop();
+                } else if (m_index && m_frame_stride > 1 &&
+                           m_nextDecodeFrame != UnknownPosition) {
+                    // For large strides jumping to a keyframe in between is
+                    // cheaper than decoding all skipped frames
+                    if (grabFrame(m_nextDecodeFrame + m_frame_stride - 1)) {
+                        m_capture->retrieve(new_frame);
+                    }
+                    return showFrame(new_frame);
+                } else {
+                    new_frame = readStrided(
+                        *m_capture, m_frame_stride, frameAllocator());
+                }
+                if (m_nextDecodeFrame != UnknownPosition) {
+                    m_nextDecodeFrame += m_frame_stride;
+                    cacheDecodedFrame(decoded, new_frame);
+                }
+                return showFrame(new_frame);
+            }
+
+            virtual bool setFrameNumber_impl(size_t frame_number) override
+            {
+                // new frame is next frame --> use next frame function
+                if (!skipsFrames() && m_nextDecodeFrame != UnknownPosition &&
+                    m_nextDecodeFrame + m_frame_stride - 1 == frame_number) {
+                    return this->nextFrame_impl();
+                } else {
+                    return seekFrame(frame_number);
+                }
+            }
+
+            virtual bool needsEveryFrame() const override
+            {
+                // The raw frame cache is filled without gaps
+                return m_recording || m_rawCacheWriter;
+            }
+
+            /**
+             * Frames are skipped by skimming and in idle segments, the frame
+             * numbers are those of the full video, so tracks line up with
+             * it.
+             */
+            virtual size_t nextFrameNumber() override
+            {
+                adoptIndex();
+                return skipIdle(skimFrameNumber());
+            }
+
+            /**
+             * When skimming, only keyframes or the frames on a grid of
+             * Config::SkimSeconds are decoded. Keyframes are taken from the
+             * seek index, without it the stream falls back to a grid of
+             * VideoIndex::DefaultAnchorInterval frames.
+             */
+            size_t skimFrameNumber()
+            {
+                const size_t current = currentFrameNumber();
+                if (_cfg->SkimKeyframes) {
+                    if (m_index && current < m_index->frameCount()) {
+                        return clampToLast(m_index->anchorAfter(current));
+                    }
+                    return clampToLast(
+                        current + VideoIndex::DefaultAnchorInterval -
+                        current % VideoIndex::DefaultAnchorInterval);
+                }
+                if (_cfg->SkimSeconds > 0) {
+                    size_t next;
+                    if (m_index && current < m_index->frameCount()) {
+                        next = m_index->frameAt(m_index->timestamp(current) +
+                                                _cfg->SkimSeconds * 1000);
+                    } else {
+                        next = current + static_cast<size_t>(
+                                             std::lround(_cfg->SkimSeconds *
+                                                         m_fps));
+                    }
+                    // frameAt clamps to the last frame
+                    return clampToLast(next > current ? next : current + 1);
+                }
+                return ImageStream::nextFrameNumber();
+            }
+
+            /**
+             * A jump beyond the end lands on the last frame instead, so that
+             * playback reaches lastFrame() and ends rather than continuing
+             * on empty frames.
+             */
+            size_t clampToLast(size_t next) const
+            {
+                const size_t last = numFrames() - 1;
+                return next > last && currentFrameNumber() < last ? last
+                                                                  : next;
+            }
+
+            /**
+             * With Config::MotionSkip, frames in segments without motion are
+             * skipped, or only every MotionIdleStride'th of them is used.
+             * Segments are active MotionPadding frames before and after
+             * motion, so that the tracker sees it start and end.
+             */
+            size_t skipIdle(size_t next) const
+            {
+                if (!_cfg->MotionSkip || !m_motion ||
+                    next >= m_motion->frameCount()) {
+                    return next;
+                }
+                const size_t active = m_motion->nextActive(
+                    next,
+                    _cfg->MotionThreshold,
+                    static_cast<size_t>(std::max(0, _cfg->MotionPadding)));
+                if (_cfg->MotionIdleStride > 0) {
+                    return clampToLast(std::max(
+                        next,
+                        std::min(active,
+                                 currentFrameNumber() +
+                                     static_cast<size_t>(
+                                         _cfg->MotionIdleStride))));
+                }
+                // Without motion up to the end, nextActive() returns
+                // frameCount()
+                return clampToLast(active);
+            }
+
+            bool skipsFrames() const
+            {
+                return _cfg->SkimKeyframes || _cfg->SkimSeconds > 0 ||
+                       (_cfg->MotionSkip && m_motion);
+            }
+
+            /**
+             * Decodes frame_number from the closest position, see
+             * grabFrame().
+             */
+            bool seekFrame(size_t frame_number)
+            {
+                // Backward playback ended, free the frames held for it
+                m_reversed = false;
+                m_reverse.reset();
+                m_reverseIndex.reset();
+                // frames read ahead belong to the old position
+                if (m_readAhead && m_readAhead->running()) {
+                    m_readAhead->stop();
+                    m_nextDecodeFrame = UnknownPosition;
+                }
+                adoptIndex();
+
+                cv::Mat new_frame;
+                new_frame.allocator = frameAllocator();
+                if (grabFrame(frame_number)) {
+                    m_capture->retrieve(new_frame);
+                }
+                return showFrame(new_frame);
+            }
+
+            virtual bool previousFrame_impl(bool playback) override
+            {
+                const size_t frame_number = currentFrameNumber() - 1;
+                // Single steps do not pay for decoding a whole segment
+                if (!playback) {
+                    return this->setFrameNumber_impl(frame_number);
+                }
+                adoptIndex();
+                // Recreated once the index is available, its keyframes
+                // bound the segments
+                if (!m_reverse || m_reverseIndex != m_index) {
+                    m_reverse = std::make_unique<ReverseDecoder>(
+                        m_fileName,
+                        m_index,
+                        static_cast<size_t>(
+                            std::max(1, _cfg->ReverseSegment)));
+                    m_reverseIndex = m_index;
+                }
+                if (!m_reverse->isOpened()) {
+                    return this->setFrameNumber_impl(frame_number);
+                }
+                m_reversed = true;
+                return showFrame(m_reverse->frame(frame_number));
+            }
+
+            bool showFrame(const cv::Mat& new_frame)
+            {
+                this->set_current_frame(new_frame);
+                if (m_recording) {
+                    if (vCoder)
+                        vCoder->add(new_frame);
+                }
+                return !new_frame.empty();
+            }
+
+            /**
+             * Positions the capture so that frame_number is the frame
+             * grabbed last. With a seek index this starts decoding at the
+             * closest anchor before the frame, or continues from the current
+             * position if that is closer, and verifies the position by the
+             * frame timestamps.
+             */
+            bool grabFrame(size_t frame_number)
+            {
+                if (!m_index || frame_number >= m_index->frameCount()) {
+                    // adjust frame position ("0-based index of the frame to
+                    // be decoded/captured next.")
+                    m_capture->set(cv::CAP_PROP_POS_FRAMES,
+                                  static_cast<double>(frame_number));
+                    m_nextDecodeFrame    = frame_number + 1;
+                    m_positionUnverified = true;
+                    return m_capture->grab();
+                }
+
+                size_t anchor = m_index->anchorBefore(frame_number);
+                while (m_nextDecodeFrame > frame_number ||
+                       m_nextDecodeFrame < anchor) {
+                    m_capture->set(cv::CAP_PROP_POS_MSEC,
+                                  m_index->timestamp(anchor));
+                    if (!m_capture->grab()) {
+                        m_nextDecodeFrame = UnknownPosition;
+                        return false;
+                    }
+                    const double landed = m_capture->get(
+                        cv::CAP_PROP_POS_MSEC);
+                    m_nextDecodeFrame    = m_index->frameAt(landed) + 1;
+                    m_positionUnverified = false;
+                    if (m_nextDecodeFrame <= frame_number + 1) {
+                        break;
+                    }
+                    // The backend landed behind the target, start from the
+                    // anchor before
+                    if (anchor == 0) {
+                        return false;
+                    }
+                    anchor = m_index->anchorBefore(anchor - 1);
+                }
+
+                while (m_nextDecodeFrame <= frame_number) {
+                    if (!m_capture->grab()) {
+                        m_nextDecodeFrame = UnknownPosition;
+                        return false;
+                    }
+                    m_nextDecodeFrame++;
+                }
+                return true;
+            }
+
+            /**
+             * Scans file for its seek index in the background, followed by
+             * its motion index with Config::MotionSkip, and stores the
+             * indices for the next time.
+             */
+            void startIndexScan(const boost::filesystem::path& file)
+            {
+                const boost::filesystem::path directory =
+                    _cfg->seekIndexDirectory().toStdString();
+                const bool motion = _cfg->MotionSkip != 0;
+                cv::Mat    mask;
+                if (motion) {
+                    mask = apertureMask(_cfg,
+                                        m_fileName,
+                                        cv::Size(static_cast<int>(m_w),
+                                                 static_cast<int>(m_h)));
+                }
+
+                std::shared_ptr<VideoIndex> index = m_index;
+                m_abortScan                       = false;
+                m_indexScan                       = std::thread(
+                    [this, file, directory, index, motion, mask]() mutable {
+                        if (!index && !directory.empty() &&
+                            !VideoIndex::unindexable(file, directory)) {
+                            index = VideoIndex::build(file, m_abortScan);
+                            if (index) {
+                                index->save(directory);
+                                std::lock_guard<std::mutex> lock(
+                                    m_indexMutex);
+                                m_scannedIndex = index;
+                            } else if (!m_abortScan) {
+                                // Not scanned again on every open
+                                VideoIndex::saveUnindexable(file, directory);
+                            }
+                        }
+                        if (!motion) {
+                            return;
+                        }
+                        auto motionIndex = MotionIndex::load(file,
+                                                             mask,
+                                                             directory);
+                        if (!motionIndex) {
+                            motionIndex = MotionIndex::build(file,
+                                                             index,
+                                                             mask,
+                                                             m_abortScan);
+                            if (motionIndex && !directory.empty()) {
+                                motionIndex->save(directory);
+                            }
+                        }
+                        if (motionIndex) {
+                            std::lock_guard<std::mutex> lock(m_indexMutex);
+                            m_scannedMotion = motionIndex;
+                        }
+                    });
+            }
+
+            /**
+             * @return the aperture stored for file in
+             * Config::AreaDefinitions as mask of size, an empty mask if
+             * there is none. The definitions are read from the file, the
+             * AreaMemory cache belongs to the GUI thread.
+             */
+            static cv::Mat apertureMask(const Config*      cfg,
+                                        const std::string& file,
+                                        cv::Size           size)
+            {
+                std::ifstream in(cfg->AreaDefinitions.toStdString());
+                std::string   line;
+                while (std::getline(in, line)) {
+                    // file#rectification#aperture#type#...
+                    std::vector<std::string> fields;
+                    BioTrackerUtilsMisc::split(line, fields, '#');
+                    if (fields.size() < 5 || fields[0] != file) {
+                        continue;
+                    }
+                    const std::vector<cv::Point> vertices =
+                        BioTrackerUtilsMisc::stringToCVPointVec(fields[2]);
+                    cv::Mat mask = cv::Mat::zeros(size, CV_8UC1);
+                    if (fields[3] == "1" && vertices.size() >= 2) {
+                        // Ellipses are given by their bounding box
+                        const cv::Rect box(vertices[0], vertices[1]);
+                        cv::ellipse(mask,
+                                    cv::RotatedRect(
+                                        (box.tl() + box.br()) * 0.5,
+                                        cv::Size2f(box.size()),
+                                        0),
+                                    cv::Scalar(255),
+                                    cv::FILLED);
+                    } else if (vertices.size() >= 3) {
+                        cv::fillPoly(mask,
+                                     std::vector<std::vector<cv::Point>>{
+                                         vertices},
+                                     cv::Scalar(255));
+                    } else {
+                        return cv::Mat();
+                    }
+                    return mask;
+                }
+                return cv::Mat();
+            }
+
+            /**
+             * Starts the raw frame cache of file, filled with the frames
+             * played anyway, so that the next run on it does not need to
+             * decode it again.
+             */
+            void startRawCache(const boost::filesystem::path& file,
+                               const cv::Mat&                 first)
+            {
+                const boost::filesystem::path directory =
+                    _cfg->RawCacheDir.toStdString();
+                if (RawFrameCache::open(file, directory)) {
+                    return;
+                }
+
+                std::uintmax_t budget = _cfg->RawCacheMB;
+                budget *= 1024 * 1024;
+                m_rawCacheWriter = RawFrameCache::Writer::start(
+                    file,
+                    directory,
+                    first,
+                    m_num_frames,
+                    m_capture->get(cv::CAP_PROP_FPS),
+                    _cfg->RawCacheGrayscale != 0,
+                    budget);
+                if (m_rawCacheWriter && !m_rawCacheWriter->append(first)) {
+                    m_rawCacheWriter.reset();
+                }
+            }
+
+            /**
+             * Appends frame number to the raw frame cache if it is the next
+             * one missing. Frames skipped by a stride or a seek forwards
+             * leave a gap, the video is not cached in this run then. An
+             * empty frame marks the end of the video.
+             */
+            void cacheDecodedFrame(size_t number, const cv::Mat& frame)
+            {
+                if (!m_rawCacheWriter ||
+                    number < m_rawCacheWriter->frameCount()) {
+                    return;
+                }
+                if (number > m_rawCacheWriter->frameCount() ||
+                    (!frame.empty() && !m_rawCacheWriter->append(frame))) {
+                    m_rawCacheWriter.reset();
+                    return;
+                }
+                if (frame.empty() || number + 1 == m_num_frames) {
+                    m_rawCacheWriter->finish();
+                    m_rawCacheWriter.reset();
+                }
+            }
+
+            void stopIndexScan()
+            {
+                m_abortScan = true;
+                if (m_indexScan.joinable()) {
+                    m_indexScan.join();
+                }
+                m_scannedIndex.reset();
+                m_scannedMotion.reset();
+            }
+
+            /**
+             * Takes over the indices once the background scan finished, the
+             * seek index also corrects the frame count reported by the
+             * container.
+             */
+            void adoptIndex()
+            {
+                if (m_index && (m_motion || !_cfg->MotionSkip)) {
+                    return;
+                }
+                std::lock_guard<std::mutex> lock(m_indexMutex);
+                if (!m_index && m_scannedIndex) {
+                    m_index      = std::move(m_scannedIndex);
+                    m_num_frames = m_index->frameCount();
+                    // Backends do not always land on the frame asked for
+                    // without the index, see grabFrame()
+                    if (m_positionUnverified) {
+                        m_nextDecodeFrame = UnknownPosition;
+                    }
+                }
+                if (m_scannedMotion) {
+                    m_motion = std::move(m_scannedMotion);
+                }
             }
+
+            static constexpr size_t UnknownPosition =
+                std::numeric_limits<size_t>::max();
+
+            std::unique_ptr<cv::VideoCapture>    m_capture;
+            size_t                               m_num_frames;
+            std::string                          m_fileName;
+            std::shared_ptr<VideoCoder>          vCoder;
+            std::vector<boost::filesystem::path> m_batch;
+            double                               m_fps;
+            double                               m_w;
+            double                               m_h;
+            bool                                 m_recording;
+
+            // Declared after m_capture, so the decoder thread is stopped
+            // before the capture is destroyed
+            std::unique_ptr<ReadAheadDecoder> m_readAhead;
+
+            // Index of the frame the capture (or the read ahead decoder)
+            // delivers next
+            size_t                      m_nextDecodeFrame    = 0;
+            // m_nextDecodeFrame was set by a seek without the index
+            bool                        m_positionUnverified = false;
+            std::shared_ptr<VideoIndex> m_index;
+            std::shared_ptr<VideoIndex> m_scannedIndex;
+            // Frames to skip with Config::MotionSkip
+            std::shared_ptr<MotionIndex> m_motion;
+            std::shared_ptr<MotionIndex> m_scannedMotion;
+            std::mutex                  m_indexMutex;
+            std::thread                 m_indexScan;
+            std::atomic<bool>           m_abortScan{false};
+            // Filled with the frames played, see cacheDecodedFrame()
+            std::unique_ptr<RawFrameCache::Writer> m_rawCacheWriter;
+
+            std::future<std::unique_ptr<OpenedVideo>> m_nextInBatch;
+
+            // Serves previous frames from segments decoded forwards, on a
+            // capture of its own
+            std::unique_ptr<ReverseDecoder> m_reverse;
+            std::shared_ptr<VideoIndex>     m_reverseIndex;
+            // The last frame came from m_reverse
+            bool m_reversed = false;
         };
 
         /*********************************************************/
 
-        class ImageStream3Pictures : public ImageStream
+        /**
+         * Serves videos from their raw frame caches instead of decoding them,
+         * see RawFrameCache.
+         */
+        class ImageStream3RawCache : public ImageStream
         {
         public:
-            explicit ImageStream3Pictures(
-                Config*                              cfg,
-                std::vector<boost::filesystem::path> picture_files)
+            /**
+             * @param caches the caches of files, in the same order
+             */
+            ImageStream3RawCache(
+                Config*                                      cfg,
+                std::vector<boost::filesystem::path>         files,
+                std::vector<std::shared_ptr<RawFrameCache>> caches)
             : ImageStream(0, cfg)
-            , m_picture_files(std::move(picture_files))
-            , m_currentFrame(0)
+            , m_files(std::move(files))
+            , m_caches(std::move(caches))
+            , m_recording(false)
             {
-
-                // Grab the codec from config file
-                double fps = _cfg->RecordFPS;
-                if (fps > 0) {
-                    m_fps = fps;
-                } else {
-                    m_fps = 1;
-                }
-
-                // load first image
-                if (this->numFrames() > 0) {
-                    this->setFrameNumber_impl(0);
-                    auto filename  = m_picture_files[0].string();
-                    auto new_frame = cv::imread(filename);
-                    m_w            = new_frame.size().width;
-                    m_h            = new_frame.size().height;
-                    m_recording    = false;
-                    vCoder         = std::make_shared<VideoCoder>(m_fps, _cfg);
-                }
+                openMedia();
             }
             virtual GuiParam::MediaType type() const override
             {
-                return GuiParam::MediaType::Images;
+                return GuiParam::MediaType::Video;
             }
             virtual size_t numFrames() const override
             {
-                return m_picture_files.size();
+                return m_caches.front()->frameCount();
             }
             virtual bool toggleRecord() override
             {
-                if (this->numFrames() <= 0) {
-                    return false;
-                }
                 m_recording = vCoder->toggle(m_w, m_h, m_fps);
 
                 return m_recording;
@@ -243,66 +2363,156 @@ namespace BioTracker
             }
             virtual std::string currentFilename() const override
             {
-                assert(currentFrameNumber() < m_picture_files.size());
-                return m_picture_files[currentFrameNumber()].string();
+                return m_files.front().string();
+            }
+            virtual double currentFrameTimestamp() const override
+            {
+                return currentFrameNumber() * 1000 /
+                       m_caches.front()->fps();
             }
 
-        private:
-            virtual bool nextFrame_impl() override
+            virtual bool hasNextInBatch() override
             {
-                m_currentFrame += static_cast<int>(m_frame_stride);
-                if (this->numFrames() > m_currentFrame) {
+                return m_files.size() > 1;
+            }
 
-                    auto filename  = m_picture_files[m_currentFrame].string();
-                    auto new_frame = cv::imread(filename);
-                    this->set_current_frame(new_frame);
-                    if (m_recording) {
-                        if (vCoder)
-                            vCoder->add(new_frame);
+            virtual void stepToNextInBatch() override
+            {
+                if (m_files.size() < 2) {
+                    throw video_open_error("batch is empty");
+                }
+                m_files.erase(m_files.begin());
+                m_caches.erase(m_caches.begin());
+                openMedia();
+            }
+
+            virtual std::vector<std::string> getBatchItems() override
+            {
+                std::vector<std::string> batchItems;
+                for (auto it = m_files.begin() + 1; it != m_files.end();
+                     ++it) {
+                    batchItems.push_back(it->string());
+                }
+                return batchItems;
+            }
+
+            /**
+             * @return the caches of all files, or an empty vector if one of
+             * them is not cached.
+             */
+            static std::vector<std::shared_ptr<RawFrameCache>> openCaches(
+                Config*                                     cfg,
+                const std::vector<boost::filesystem::path>& files)
+            {
+                std::vector<std::shared_ptr<RawFrameCache>> caches;
+                for (const auto& file : files) {
+                    auto cache = RawFrameCache::open(
+                        file, cfg->RawCacheDir.toStdString());
+                    if (!cache) {
+                        return {};
                     }
-                    return true;
+                    caches.push_back(cache);
                 }
-                return false;
+                return caches;
+            }
+
+        private:
+            void openMedia()
+            {
+                // Grab the fps from config file
+                double fps = _cfg->RecordFPS;
+                m_fps      = fps != -1 ? fps : m_caches.front()->fps();
+
+                m_recording = false;
+                setFrameNumber_impl(0);
+                m_current_frame_number = 0;
+
+                m_w    = currentFrame().cols;
+                m_h    = currentFrame().rows;
+                vCoder = std::make_shared<VideoCoder>(m_fps, _cfg);
+            }
+
+            virtual bool nextFrame_impl() override
+            {
+                return setFrameNumber_impl(m_currentFrame + m_frame_stride);
             }
 
             virtual bool setFrameNumber_impl(size_t frame_number) override
             {
-                auto filename  = m_picture_files[frame_number].string();
-                auto new_frame = cv::imread(filename);
+                cv::Mat new_frame = m_caches.front()->frame(frame_number);
+                m_currentFrame    = frame_number;
                 this->set_current_frame(new_frame);
-                m_currentFrame = static_cast<int>(frame_number);
                 if (m_recording) {
                     if (vCoder)
                         vCoder->add(new_frame);
                 }
                 return !new_frame.empty();
             }
-            std::vector<boost::filesystem::path> m_picture_files;
-            std::shared_ptr<VideoCoder>          vCoder;
-            double                               m_w;
-            double                               m_h;
-            bool                                 m_recording;
-            int                                  m_currentFrame;
-            double                               m_fps;
+
+            std::vector<boost::filesystem::path>        m_files;
+            std::vector<std::shared_ptr<RawFrameCache>> m_caches;
+            std::shared_ptr<VideoCoder>                 vCoder;
+            size_t                                      m_currentFrame = 0;
+            double                                      m_fps;
+            double                                      m_w;
+            double                                      m_h;
+            bool                                        m_recording;
         };
 
         /*********************************************************/
 
-        class ImageStream3Video : public ImageStream
+        /**
+         * Plays consecutive video files, e.g. a long recording split into
+         * several files by the camera software, as one stream with a global
+         * frame numbering. The segments next to the current one are kept
+         * open, so that crossing a boundary does not stall.
+         */
+        class ImageStream3Segmented : public ImageStream
         {
         public:
+            using SegmentPtr = std::shared_ptr<ImageStream3Video>;
+
             /**
-             * @throw file_not_found when the file does not exists
-             * @throw video_open_error when there is an error with the video
-             * @brief ImageStreamVideo
-             * @param filename path to the file
+             * @throw file_not_found when a file does not exist
+             * @throw video_open_error when the first file can not be opened
              */
-            explicit ImageStream3Video(
-                Config*                                     cfg,
-                const std::vector<boost::filesystem::path>& files)
+            ImageStream3Segmented(Config*                              cfg,
+                                  std::vector<boost::filesystem::path> files)
             : ImageStream(0, cfg)
+            , m_files(std::move(files))
+            , m_segmentCfg(*cfg)
             {
-                openMedia(files);
+                // Frames are cached and recorded by the segmented stream
+                m_segmentCfg.FrameCacheMB = 0;
+                m_segmentCfg.RawCacheMB   = 0;
+                m_segmentCfg.BatchPreOpen = 0;
+
+                m_firstFrame.push_back(0);
+                for (const auto& file : m_files) {
+                    if (!boost::filesystem::exists(file)) {
+                        throw file_not_found("Could not find file " +
+                                             file.string());
+                    }
+                    m_firstFrame.push_back(m_firstFrame.back() +
+                                           probeFrameCount(file));
+                }
+
+                SegmentPtr first = segment(0);
+                if (!first) {
+                    throw video_open_error("Could not open " +
+                                           m_files.front().string());
+                }
+
+                // Grab the fps from config file
+                double fps = _cfg->RecordFPS;
+                m_fps      = fps != -1 ? fps : first->fps();
+
+                enableFrameCache();
+                m_recording = false;
+                setFrameNumber_impl(0);
+                m_w    = currentFrame().cols;
+                m_h    = currentFrame().rows;
+                vCoder = std::make_shared<VideoCoder>(m_fps, _cfg);
             }
             virtual GuiParam::MediaType type() const override
             {
@@ -310,13 +2520,10 @@ namespace BioTracker
             }
             virtual size_t numFrames() const override
             {
-                return m_num_frames;
+                return m_firstFrame.back();
             }
             virtual bool toggleRecord() override
             {
-                if (!m_capture.isOpened()) {
-                    return false;
-                }
                 m_recording = vCoder->toggle(m_w, m_h, m_fps);
 
                 return m_recording;
@@ -327,107 +2534,210 @@ namespace BioTracker
             }
             virtual std::string currentFilename() const override
             {
-                return m_fileName;
+                const size_t index = std::min(
+                    segmentOf(currentFrameNumber()), m_files.size() - 1);
+                return m_files[index].string();
+            }
+            virtual double currentFrameTimestamp() const override
+            {
+                // The time stamps of a segment continue where the previous
+                // one ended
+                const size_t frame = currentFrameNumber();
+                const size_t index = segmentOf(frame);
+                auto         it    = m_segments.find(index);
+                if (it != m_segments.end() &&
+                    it->second->currentFrameNumber() ==
+                        frame - m_firstFrame[index]) {
+                    const double timestamp =
+                        it->second->currentFrameTimestamp();
+                    if (timestamp >= 0) {
+                        return m_firstFrame[index] * 1000 /
+                                   it->second->fps() +
+                               timestamp;
+                    }
+                }
+                return frame * 1000 / m_fps;
             }
 
-            virtual bool hasNextInBatch() override
+        private:
+            virtual bool nextFrame_impl() override
             {
-                return !(m_batch.empty());
+                return setFrameNumber_impl(currentFrameNumber() +
+                                           m_frame_stride);
             }
 
-            virtual void stepToNextInBatch() override
+            virtual bool setFrameNumber_impl(size_t frame_number) override
             {
-                if (m_batch.empty()) {
-                    throw video_open_error("batch is empty");
+                // The frame counts of the segments get exact once they are
+                // opened, which may move frame_number to another segment
+                size_t     index = 0;
+                SegmentPtr stream;
+                do {
+                    index = segmentOf(frame_number);
+                    if (index >= m_files.size()) {
+                        this->set_current_frame(cv::Mat());
+                        return false;
+                    }
+                    // A segment that can not be opened is skipped
+                    stream = segment(index);
+                    updateFrameCount(index, stream ? stream->numFrames() : 0);
+                } while (segmentOf(frame_number) != index);
+
+                // Sequential access is detected by the segment itself
+                stream->setFrameNumber(frame_number - m_firstFrame[index]);
+                updateFrameCount(index, stream->numFrames());
+                warmNeighbours(index);
+
+                cv::Mat new_frame = stream->currentFrame();
+                this->set_current_frame(new_frame);
+                if (m_recording) {
+                    if (vCoder)
+                        vCoder->add(new_frame);
                 }
-                openMedia(m_batch);
+                return !new_frame.empty();
             }
 
-            virtual std::vector<std::string> getBatchItems() override
+            virtual bool needsEveryFrame() const override
             {
-                std::vector<std::string> batchItems;
-                for (auto x : m_batch) {
-                    batchItems.push_back(x.string());
-                }
-                return batchItems;
+                return m_recording;
             }
 
-        private:
-            void openMedia(std::vector<boost::filesystem::path> files)
+            /**
+             * @return the number of frames of file, exact if it has a seek
+             * index.
+             */
+            size_t probeFrameCount(const boost::filesystem::path& file) const
             {
+                const boost::filesystem::path directory =
+                    _cfg->seekIndexDirectory().toStdString();
+                if (!directory.empty()) {
+                    if (auto index = VideoIndex::load(file, directory)) {
+                        return index->frameCount();
+                    }
+                }
+                cv::VideoCapture capture(file.string());
+                return static_cast<size_t>(
+                    std::max(0.0, capture.get(cv::CAP_PROP_FRAME_COUNT)));
+            }
 
-                m_capture.open(files.front().string());
-                m_num_frames = static_cast<size_t>(
-                    m_capture.get(cv::CAP_PROP_FRAME_COUNT));
-                m_fps      = m_capture.get(cv::CAP_PROP_FPS);
-                m_fileName = files.front().string();
+            /**
+             * @return the segment containing the global frame_number, the
+             * number of segments if it lies behind the last one.
+             */
+            size_t segmentOf(size_t frame_number) const
+            {
+                auto it = std::upper_bound(
+                    m_firstFrame.begin(), m_firstFrame.end(), frame_number);
+                return static_cast<size_t>(it - m_firstFrame.begin()) - 1;
+            }
 
-                if (!boost::filesystem::exists(files.front())) {
-                    throw file_not_found("Could not find file " +
-                                         files.front().string());
+            void updateFrameCount(size_t index, size_t frames)
+            {
+                const size_t old = m_firstFrame[index + 1] -
+                                   m_firstFrame[index];
+                if (frames == old) {
+                    return;
                 }
-                if (!m_capture.isOpened()) {
-                    throw video_open_error(":(");
+                for (size_t i = index + 1; i < m_firstFrame.size(); i++) {
+                    m_firstFrame[i] = m_firstFrame[i] - old + frames;
                 }
+            }
 
-                m_batch = files;
-                m_batch.erase(m_batch.begin(), m_batch.begin() + 1);
-
-                // Grab the fps from config file
-                double fps = _cfg->RecordFPS;
-                if (fps != -1) {
-                    m_fps = fps;
+            /**
+             * @return segment index, nullptr if it can not be opened.
+             */
+            SegmentPtr segment(size_t index)
+            {
+                auto it = m_segments.find(index);
+                if (it != m_segments.end()) {
+                    return it->second;
                 }
-
-                m_w         = m_capture.get(cv::CAP_PROP_FRAME_WIDTH);
-                m_h         = m_capture.get(cv::CAP_PROP_FRAME_HEIGHT);
-                m_recording = false;
-                vCoder      = std::make_shared<VideoCoder>(m_fps, _cfg);
-
-                // load first image
-                if (this->numFrames() > 0) {
-                    this->nextFrame_impl();
+                if (m_broken.count(index)) {
+                    return nullptr;
                 }
 
-                m_current_frame_number = 0;
+                SegmentPtr stream;
+                if (m_warming.valid() && m_warmingIndex == index) {
+                    stream = m_warming.get();
+                } else {
+                    stream = openSegment(index, this->thread());
+                }
+                if (!stream) {
+                    m_broken.insert(index);
+                    return nullptr;
+                }
+                m_segments[index] = stream;
+                return stream;
             }
 
-            virtual bool nextFrame_impl() override
+            /**
+             * Opens segment index, possibly on a worker thread, and hands it
+             * to the thread owner, which uses it.
+             * @return nullptr if the file is missing, corrupt or unreadable
+             */
+            SegmentPtr openSegment(size_t index, QThread* owner)
             {
-                cv::Mat new_frame;
-                for (int i = 0; i < m_frame_stride; i++)
-                    m_capture >> new_frame;
-                this->set_current_frame(new_frame);
-                if (m_recording) {
-                    if (vCoder)
-                        vCoder->add(new_frame);
+                try {
+                    auto stream = std::make_shared<ImageStream3Video>(
+                        &m_segmentCfg,
+                        std::vector<boost::filesystem::path>{m_files[index]});
+                    stream->moveToThread(owner);
+                    return stream;
+                } catch (const std::exception& e) {
+                    qWarning() << "Segmented stream: skipped"
+                               << QString::fromStdString(
+                                      m_files[index].string())
+                               << "-" << e.what();
+                    return nullptr;
                 }
-                return !new_frame.empty();
             }
 
-            virtual bool setFrameNumber_impl(size_t frame_number) override
+            /**
+             * Closes all segments but the neighbours of index and opens the
+             * following one in the background.
+             */
+            void warmNeighbours(size_t index)
             {
-                // new frame is next frame --> use next frame function
-                if (this->currentFrameNumber() + 1 == frame_number) {
-                    return this->nextFrame_impl();
-                } else {
-                    // adjust frame position ("0-based index of the frame to be
-                    // decoded/captured next.")
-                    m_capture.set(cv::CAP_PROP_POS_FRAMES,
-                                  static_cast<double>(frame_number));
-                    return this->nextFrame_impl();
+                for (auto it = m_segments.begin(); it != m_segments.end();) {
+                    if (it->first + 1 < index || it->first > index + 1) {
+                        it = m_segments.erase(it);
+                    } else {
+                        ++it;
+                    }
                 }
+
+                const size_t next = index + 1;
+                if (next >= m_files.size() || m_segments.count(next) ||
+                    m_broken.count(next) ||
+                    (m_warming.valid() && m_warmingIndex == next)) {
+                    return;
+                }
+                if (m_warming.valid()) {
+                    m_warming.wait();
+                }
+                QThread* owner = this->thread();
+                m_warmingIndex = next;
+                m_warming      = std::async(std::launch::async,
+                                       [this, next, owner] {
+                                           return openSegment(next, owner);
+                                       });
             }
 
-            cv::VideoCapture                     m_capture;
-            size_t                               m_num_frames;
-            std::string                          m_fileName;
-            std::shared_ptr<VideoCoder>          vCoder;
-            std::vector<boost::filesystem::path> m_batch;
-            double                               m_fps;
-            double                               m_w;
-            double                               m_h;
-            bool                                 m_recording;
+            std::vector<boost::filesystem::path> m_files;
+            // First global frame number of each segment, followed by the
+            // total number of frames
+            std::vector<size_t>          m_firstFrame;
+            Config                       m_segmentCfg;
+            std::map<size_t, SegmentPtr> m_segments;
+            // Segments that could not be opened, played as 0 frames
+            std::set<size_t>             m_broken;
+            std::future<SegmentPtr>      m_warming;
+            size_t                       m_warmingIndex = 0;
+            std::shared_ptr<VideoCoder>  vCoder;
+            double                       m_fps;
+            double                       m_w;
+            double                       m_h;
+            bool                         m_recording;
         };
 
         /*********************************************************/
@@ -443,16 +2753,10 @@ namespace BioTracker
             explicit ImageStream3OpenCVCamera(Config*             cfg,
                                               CameraConfiguration conf)
             : ImageStream(0, cfg)
-            , m_capture(conf._selector.name)
-            , m_fps(m_capture.get(cv::CAP_PROP_FPS))
+            , m_acquisition(std::max(1, cfg->CameraRing))
+            , m_timestamp(-1)
+            , m_nextSequence(0)
             {
-                // Give the camera some extra time to get ready:
-                // Somehow opening it on first try sometimes does not succeed.
-                // Workaround:
-                // http://stackoverflow.com/questions/22019064/unable-to-read-frames-from-videocapture-from-secondary-webcam-with-opencv?rq=1
-                // So, stubbornly try it a few times until it works.
-                std::this_thread::sleep_for(std::chrono::milliseconds(1000));
-
                 qDebug() << "\nStarting to record on camera no. "
                          << conf._selector.index;
                 m_w   = conf._width == -1 ? _cfg->CameraWidth : conf._width;
@@ -461,31 +2765,37 @@ namespace BioTracker
                 m_recording = false;
                 vCoder      = std::make_shared<VideoCoder>(m_fps, _cfg);
 
-                int fails = 0;
-                while (!m_capture.isOpened() && fails < 5) {
-                    m_capture.open(conf._selector.index);
-                    std::this_thread::sleep_for(
-                        std::chrono::milliseconds(1000));
-                    fails++;
-                }
-
-                if (!m_capture.isOpened()) {
+                // Some cameras do not open on the first try, nor deliver
+                // frames right away:
+                // http://stackoverflow.com/questions/22019064/unable-to-read-frames-from-videocapture-from-secondary-webcam-with-opencv?rq=1
+                // Both are polled for, rather than waited for blindly
+                const std::chrono::milliseconds timeout(
+                    std::max(0, _cfg->CameraOpenTimeout));
+                m_capture = CameraProbe::open(conf._selector, timeout);
+                if (!m_capture) {
                     qWarning() << "Unable to open camera!";
                     throw device_open_error(":(");
                 }
 
                 if (m_w != -1)
-                    m_capture.set(cv::CAP_PROP_FRAME_WIDTH, m_w);
+                    m_capture->set(cv::CAP_PROP_FRAME_WIDTH, m_w);
                 if (m_h != -1)
-                    m_capture.set(cv::CAP_PROP_FRAME_HEIGHT, m_h);
+                    m_capture->set(cv::CAP_PROP_FRAME_HEIGHT, m_h);
                 if (m_fps != -1)
-                    m_capture.set(cv::CAP_PROP_FPS, m_fps);
+                    m_capture->set(cv::CAP_PROP_FPS, m_fps);
 
-                m_w   = m_capture.get(cv::CAP_PROP_FRAME_WIDTH);
-                m_h   = m_capture.get(cv::CAP_PROP_FRAME_HEIGHT);
-                m_fps = m_capture.get(cv::CAP_PROP_FPS);
-                qDebug() << "Cam open: " << m_capture.isOpened()
+                if (!CameraProbe::waitForFrame(*m_capture, timeout)) {
+                    qWarning() << "Camera delivers no frames!";
+                    throw device_open_error("No frames from camera");
+                }
+
+                m_w   = m_capture->get(cv::CAP_PROP_FRAME_WIDTH);
+                m_h   = m_capture->get(cv::CAP_PROP_FRAME_HEIGHT);
+                m_fps = m_capture->get(cv::CAP_PROP_FPS);
+                pixelFormatChanged();
+                qDebug() << "Cam open: " << m_capture->isOpened()
                          << " w/h:" << m_w << "/" << m_h << " fps:" << m_fps;
+                m_acquisition.start(m_capture.get());
                 // load first image
                 if (this->numFrames() > 0) {
                     this->nextFrame_impl();
@@ -501,7 +2811,7 @@ namespace BioTracker
             }
             virtual bool toggleRecord() override
             {
-                if (!m_capture.isOpened()) {
+                if (!m_capture->isOpened()) {
                     return false;
                 }
                 m_recording = vCoder->toggle(m_w, m_h, m_fps);
@@ -516,14 +2826,33 @@ namespace BioTracker
             {
                 return "Camera"; // TODO be more specific!
             }
+            virtual double currentFrameTimestamp() const override
+            {
+                return m_timestamp;
+            }
 
         private:
             virtual bool nextFrame_impl() override
             {
+                // Of stride consecutive frames only the last one is used
                 cv::Mat new_frame;
-
-                for (int i = 0; i < m_frame_stride; i++) {
-                    m_capture >> new_frame;
+                for (size_t i = 0; i < m_frame_stride; i++) {
+                    auto frame = m_acquisition.pop();
+                    if (!frame) {
+                        new_frame = cv::Mat();
+                        break;
+                    }
+                    if (frame->sequence > m_nextSequence) {
+                        qWarning() << "Camera: dropped"
+                                   << frame->sequence - m_nextSequence
+                                   << "frames";
+                    }
+                    m_nextSequence = frame->sequence + 1;
+                    new_frame      = frame->image;
+                    m_timestamp =
+                        std::chrono::duration<double, std::milli>(
+                            frame->captured - m_acquisition.started())
+                            .count();
                 }
 
                 this->set_current_frame(new_frame);
@@ -542,12 +2871,28 @@ namespace BioTracker
                 return true;
             }
 
-            std::shared_ptr<VideoCoder> vCoder;
-            cv::VideoCapture            m_capture;
-            double                      m_fps;
-            double                      m_w;
-            double                      m_h;
-            bool                        m_recording;
+            virtual void pixelFormatChanged() override
+            {
+                // Raw hands out the buffers of the device, if the backend
+                // supports it
+                const bool running = m_acquisition.running();
+                m_acquisition.stop();
+                m_capture->set(cv::CAP_PROP_CONVERT_RGB,
+                               m_pixel_format != PixelFormat::Raw);
+                if (running) {
+                    m_acquisition.start(m_capture.get());
+                }
+            }
+
+            std::shared_ptr<VideoCoder>       vCoder;
+            std::shared_ptr<cv::VideoCapture> m_capture;
+            CameraAcquisition                 m_acquisition;
+            double                            m_fps;
+            double                            m_w;
+            double                            m_h;
+            bool                              m_recording;
+            double                            m_timestamp;
+            std::uint64_t                     m_nextSequence;
         };
 
 #if HAS_PYLON
@@ -670,9 +3015,17 @@ namespace BioTracker
                     return false;
                 }
 
-                auto view   = toOpenCV(m_grabbed);
-                auto scaled = view.clone();
-                cv::resize(scaled, scaled, m_imageSize);
+                // view references the grab buffer. A raw Bayer pattern must
+                // not be interpolated
+                auto    view = toOpenCV(m_grabbed, m_pixel_format);
+                cv::Mat scaled;
+                scaled.allocator = frameAllocator();
+                if (view.size() == m_imageSize ||
+                    m_pixel_format == PixelFormat::Raw) {
+                    view.copyTo(scaled);
+                } else {
+                    cv::resize(view, scaled, m_imageSize);
+                }
                 set_current_frame(scaled);
                 if (m_recording && m_encoder)
                     m_encoder->add(scaled);
@@ -738,6 +3091,21 @@ namespace BioTracker
             const std::vector<boost::filesystem::path>& files)
         {
             try {
+                if (cfg->ConcatenateVideos && files.size() > 1) {
+                    return std::make_shared<ImageStream3Segmented>(cfg,
+                                                                   files);
+                }
+                // Serve the files from their raw frame caches, if all of
+                // them were decoded before
+                if (cfg->RawCacheMB > 0) {
+                    auto caches = ImageStream3RawCache::openCaches(cfg, files);
+                    if (!caches.empty()) {
+                        return std::make_shared<ImageStream3RawCache>(
+                            cfg,
+                            files,
+                            std::move(caches));
+                    }
+                }
                 return std::make_shared<ImageStream3Video>(cfg, files);
             } catch (const video_open_error&) {
                 return make_ImageStream3NoMedia();
@@ -767,5 +3135,61 @@ namespace BioTracker
             }
         }
 
+        std::shared_ptr<ImageStream> make_ImageStream3Source(
+            Config*            cfg,
+            const std::string& uri)
+        {
+            const QUrl url(QString::fromStdString(uri));
+            try {
+                if (url.scheme() == "synthetic") {
+                    return std::make_shared<ImageStream3Synthetic>(
+                        cfg,
+                        QUrlQuery(url));
+                }
+                if (url.scheme() == "shm") {
+                    bool      ok      = false;
+                    const int timeout = QUrlQuery(url)
+                                            .queryItemValue("timeout")
+                                            .toInt(&ok);
+                    return std::make_shared<ImageStream3SharedMemory>(
+                        cfg,
+                        url.path().toStdString(),
+                        ok ? timeout : 5000);
+                }
+                if (url.scheme() == "pipe") {
+                    return std::make_shared<ImageStream3Pipe>(
+                        cfg,
+                        url.path().toStdString(),
+                        QUrlQuery(url));
+                }
+                if (url.scheme() == "folder") {
+                    return std::make_shared<ImageStream3Folder>(
+                        cfg,
+                        url.path().toStdString(),
+                        QUrlQuery(url));
+                }
+                const QStringList network = {"rtsp",
+                                             "rtsps",
+                                             "rtp",
+                                             "udp",
+                                             "tcp",
+                                             "srt",
+                                             "http",
+                                             "https"};
+                if (network.contains(url.scheme())) {
+                    return std::make_shared<ImageStream3Network>(cfg, uri);
+                }
+                if (url.scheme() == "composite") {
+                    return std::make_shared<ImageStream3Composite>(
+                        cfg,
+                        QUrlQuery(url));
+                }
+                throw source_open_error("Unknown stream source " + uri);
+            } catch (const source_open_error& e) {
+                qWarning() << e.what();
+                return make_ImageStream3NoMedia();
+            }
+        }
+
     }
 }
@@ -20,6 +20,8 @@
 #include "util/types.h"
 #include "util/camera/base.h"
 #include "util/Config.h"
+#include "util/FrameCache.h"
+#include "util/PixelFormat.h"
 
 namespace BioTracker
 {
@@ -88,6 +90,13 @@ namespace BioTracker
              */
             cv::Mat currentFrame() const;
 
+            /**
+             * @return the time the current frame was captured, in
+             * milliseconds since the stream started, or a negative value if
+             * the stream does not know it.
+             */
+            virtual double currentFrameTimestamp() const;
+
             /**
              * sets the current frame number and updates the current frame.
              * - if frame_number is invalid, the current frame is invalidated.
@@ -109,10 +118,12 @@ namespace BioTracker
              * sets the current frame position to the previous frame.
              * - if this function is called on the media's first frame, the
              * current frame is invalidated.
+             * @param playback true if called for every frame of backward
+             * playback, which streams may prepare frames ahead for
              * @return true if the operation was successful, i.e. the current
              * frame isn't the first one and no error occurred.
              */
-            bool previousFrame();
+            bool previousFrame(bool playback = false);
 
             /**
              * Gets the title of the current image stream.
@@ -130,6 +141,22 @@ namespace BioTracker
 
             virtual std::vector<std::string> getBatchItems();
 
+            /**
+             * Sets the pixel format of the delivered frames. Streams produce
+             * it at the source where they can, otherwise frames are converted
+             * once when they become the current frame.
+             */
+            void setPixelFormat(PixelFormat format);
+
+            PixelFormat pixelFormat() const;
+
+            /**
+             * @return the number of frames served from / missed by the frame
+             * cache, 0 without cache.
+             */
+            size_t frameCacheHits() const;
+            size_t frameCacheMisses() const;
+
             virtual ~ImageStream();
 
         protected:
@@ -149,6 +176,33 @@ namespace BioTracker
              */
             void setTitle(std::string title);
 
+            /**
+             * Keeps recently decoded frames in memory, within the budget of
+             * Config::FrameCacheMB, so that stepping back and small jumps do
+             * not need the decoder. Only meaningful for seekable media.
+             */
+            void enableFrameCache();
+
+            /**
+             * Drops all cached frames, has to be called when the media
+             * changes.
+             */
+            void clearFrameCache();
+
+            /**
+             * @return the allocator for the buffers the stream decodes into:
+             * the shared FramePool with Config::FramePoolMB, else nullptr for
+             * the default allocation.
+             */
+            cv::MatAllocator* frameAllocator() const;
+
+            /**
+             * The frame nextFrame() advances to. Defaults to
+             * currentFrameNumber() + m_frame_stride, implementations that
+             * skip frames differently override it.
+             */
+            virtual size_t nextFrameNumber();
+
             /**
              * The stride of the image stream. Think of it as "use only every
              * n'th frame".
@@ -159,6 +213,7 @@ namespace BioTracker
             size_t      m_current_frame_number;
             std::string m_title;
             Config*     _cfg;
+            PixelFormat m_pixel_format;
 
         private:
             /**
@@ -166,6 +221,19 @@ namespace BioTracker
              * this->numFrames();
              */
             void clearImage();
+
+            /**
+             * Makes the cached frame frame_number the current frame.
+             * @return false if frame_number is not cached.
+             */
+            bool takeCachedFrame(size_t frame_number);
+
+            void cacheCurrentFrame(size_t frame_number);
+
+            std::unique_ptr<FrameCache> m_frame_cache;
+            // false if the current frame was served from the cache and the
+            // implementation is still positioned elsewhere
+            bool m_decoder_in_sync;
             /**
              * - called by ImageStreamImpl::setFrameNumber
              *    if frame_number < numFrames() && frame_number !=
@@ -184,7 +252,18 @@ namespace BioTracker
              *    if currentFrameNumber() > 0;
              * - m_current_frame_number is updated afterwards
              */
-            virtual bool previousFrame_impl();
+            virtual bool previousFrame_impl(bool playback);
+            /**
+             * - called by ImageStream::setPixelFormat() after
+             *    m_pixel_format changed
+             */
+            virtual void pixelFormatChanged();
+            /**
+             * - called before a frame is served from the frame cache
+             * @return true while the implementation has to decode every
+             *    frame itself, e.g. to record it
+             */
+            virtual bool needsEveryFrame() const;
         };
 
         std::shared_ptr<ImageStream> make_ImageStream3NoMedia();
@@ -201,6 +280,30 @@ namespace BioTracker
             Config*             cfg,
             CameraConfiguration conf);
 
+        /**
+         * Opens a stream source given by URI, the scheme selects the
+         * implementation:
+         * - synthetic:?width=&height=&fps=&frames=&blobs=&radius=&speed=
+         *   &noise=&format=&paced=&seed=&truth= renders moving blobs
+         * - shm:<name>?timeout= reads the SharedFrameRing name, written by
+         *   another process
+         * - pipe:<path>?width=&height=&fps=&format=&buffer=&timeout= reads
+         *   raw frames (bgr24, bgra or gray) from a named pipe, pipe:- from
+         *   stdin
+         * - folder:<path>?timeout=&buffer=&fps= delivers the images written
+         *   into the folder path while the stream is open
+         * - rtsp, rtsps, rtp, udp, tcp, srt, http and https URLs receive a
+         *   network stream, buffered as Config::NetworkLatency and
+         *   Config::NetworkBuffer set
+         * - composite:?source=&source=...&offset=&align=&fps=&columns=&labels=
+         *   plays the percent-encoded sources (file paths, camera:<index> or
+         *   URIs) in sync as a mosaic, aligned by frame or time offsets
+         * Unknown schemes and invalid parameters yield the NoMedia stream.
+         */
+        std::shared_ptr<ImageStream> make_ImageStream3Source(
+            Config*            cfg,
+            const std::string& uri);
+
     }
 }
 
@@ -1,5 +1,6 @@
 #include "MediaPlayer.h"
 #include "Utility/misc.h"
+#include "util/FramePool.h"
 
 // Settings related
 #include "util/types.h"
@@ -23,6 +24,8 @@ MediaPlayer::MediaPlayer(QObject* parent)
 
     m_TrackingIsActive = false;
     m_recd             = false;
+    m_frameCacheHits   = 0;
+    m_frameCacheMisses = 0;
     m_recordScaled     = false;
     // Initialize PlayerStateMachine and a Thread for the Player
     //    // Do not set a Parent for MediaPlayerStateMachine in order to run
@@ -48,6 +51,10 @@ MediaPlayer::MediaPlayer(QObject* parent)
                      &MediaPlayer::loadPictures,
                      m_Player,
                      &MediaPlayerStateMachine::receiveLoadPictures);
+    QObject::connect(this,
+                     &MediaPlayer::loadStreamSource,
+                     m_Player,
+                     &MediaPlayerStateMachine::receiveLoadStreamSource);
 
     // Controll the Player
     QObject::connect(this,
@@ -66,6 +73,10 @@ MediaPlayer::MediaPlayer(QObject* parent)
                      &MediaPlayer::prevFrameCommand,
                      m_Player,
                      &MediaPlayerStateMachine::receivePrevFrameCommand);
+    QObject::connect(this,
+                     &MediaPlayer::playBackwardsCommand,
+                     m_Player,
+                     &MediaPlayerStateMachine::receivePlayBackwardsCommand);
     QObject::connect(this,
                      &MediaPlayer::stopCommand,
                      m_Player,
@@ -74,6 +85,10 @@ MediaPlayer::MediaPlayer(QObject* parent)
                      &MediaPlayer::goToFrame,
                      m_Player,
                      &MediaPlayerStateMachine::receiveGoToFrame);
+    QObject::connect(this,
+                     &MediaPlayer::pixelFormatCommand,
+                     m_Player,
+                     &MediaPlayerStateMachine::receivePixelFormat);
 
     QObject::connect(this,
                      &MediaPlayer::pauseCommand,
@@ -84,6 +99,29 @@ MediaPlayer::MediaPlayer(QObject* parent)
                      this,
                      &MediaPlayer::receiveTrackingPaused);
 
+    // Provide the background of loaded videos
+    m_Background = new BackgroundService(this, _cfg);
+    QObject::connect(m_Background,
+                     &BackgroundService::backgroundReady,
+                     this,
+                     &MediaPlayer::receiveBackground);
+    QObject::connect(this,
+                     &MediaPlayer::loadVideoStream,
+                     this,
+                     &MediaPlayer::receiveLoadVideoStream);
+    QObject::connect(this,
+                     &MediaPlayer::loadPictures,
+                     this,
+                     &MediaPlayer::receiveLoadOtherMedia);
+    QObject::connect(this,
+                     &MediaPlayer::loadCameraDevice,
+                     this,
+                     &MediaPlayer::receiveLoadOtherMedia);
+    QObject::connect(this,
+                     &MediaPlayer::loadStreamSource,
+                     this,
+                     &MediaPlayer::receiveLoadOtherMedia);
+
     QObject::connect(this,
                      &MediaPlayer::toggleRecordImageStreamCommand,
                      m_Player,
@@ -137,6 +175,26 @@ MediaPlayer::~MediaPlayer()
     }
 }
 
+void MediaPlayer::receiveLoadVideoStream(
+    std::vector<boost::filesystem::path> files)
+{
+    m_VideoFiles = files;
+}
+
+void MediaPlayer::receiveLoadOtherMedia()
+{
+    m_VideoFiles.clear();
+    m_Background->reset();
+}
+
+void MediaPlayer::receiveBackground(QString video, cv::Mat background)
+{
+    // The previous video may have finished after the switch
+    if (video == m_CurrentFilename) {
+        Q_EMIT backgroundChanged(background);
+    }
+}
+
 void MediaPlayer::setTrackingActive()
 {
     m_TrackingIsActive = true;
@@ -207,6 +265,16 @@ double MediaPlayer::getCurrentFPS()
     return m_currentFPS;
 }
 
+size_t MediaPlayer::getFrameCacheHits()
+{
+    return m_frameCacheHits;
+}
+
+size_t MediaPlayer::getFrameCacheMisses()
+{
+    return m_frameCacheMisses;
+}
+
 double MediaPlayer::getTargetFPS()
 {
     return m_targetFPS;
@@ -318,10 +386,27 @@ void MediaPlayer::receivePlayerParameters(
     m_RecI = param->m_RecI;
     m_RecO = param->m_RecO;
 
+    const bool mediaChanged = m_CurrentFilename != param->m_CurrentFilename;
+
     m_CurrentFilename    = param->m_CurrentFilename;
     m_CurrentFrameNumber = param->m_CurrentFrameNumber;
     m_fpsOfSourceFile    = param->m_fpsSourceVideo;
     m_TotalNumbFrames    = param->m_TotalNumbFrames;
+    m_frameCacheHits     = param->m_frameCacheHits;
+    m_frameCacheMisses   = param->m_frameCacheMisses;
+
+    // Batches switch videos in the player thread, so follow the file name
+    if (mediaChanged) {
+        Q_EMIT backgroundChanged(cv::Mat());
+    }
+    if (_cfg->Background) {
+        for (const auto& file : m_VideoFiles) {
+            if (QString::fromStdString(file.string()) == m_CurrentFilename) {
+                m_Background->compute(file);
+                break;
+            }
+        }
+    }
 
     if (param->m_CurrentFrame && !param->m_CurrentFrame->empty()) {
         m_CurrentFrame = *param->m_CurrentFrame;
@@ -329,8 +414,14 @@ void MediaPlayer::receivePlayerParameters(
         Q_EMIT renderCurrentImage(m_CurrentFrame, m_NameOfCvMat);
 
         if (m_TrackingIsActive) {
-            Q_EMIT trackCurrentImage(m_CurrentFrame,
-                                     static_cast<uint>(m_CurrentFrameNumber));
+            // The frame cache shares its frames with the player, plugins
+            // drawing into their input must not change cached frames
+            const cv::Mat input = _cfg->FrameCacheMB > 0
+                                      ? m_CurrentFrame.clone()
+                                      : m_CurrentFrame;
+            Q_EMIT trackCurrentImage(input,
+                                     static_cast<uint>(m_CurrentFrameNumber),
+                                     param->m_CurrentFrameTimestamp);
         } else {
             Q_EMIT signalVisualizeCurrentModel(
                 static_cast<uint>(m_CurrentFrameNumber));
@@ -364,8 +455,10 @@ void MediaPlayer::receivePlayerParameters(
                                 m_image.bits(),
                                 m_image.bytesPerLine());
 
-            auto copy = view.clone();
-            cv::cvtColor(copy, copy, cv::ColorConversionCodes::COLOR_BGR2RGB);
+            // Converted straight from the view into a pooled buffer
+            cv::Mat copy;
+            copy.allocator = FramePool::instance();
+            cv::cvtColor(view, copy, cv::ColorConversionCodes::COLOR_BGR2RGB);
             m_videoc->add(copy);
         }
     } else {
@@ -11,6 +11,7 @@
 #include "Interfaces/IModel/IModel.h"
 #include "QThread"
 #include "Model/MediaPlayerStateMachine/MediaPlayerStateMachine.h"
+#include "Model/BackgroundService.h"
 #include "View/GraphicsView.h"
 
 #include <ctime>
@@ -54,6 +55,12 @@ Q_SIGNALS:
      * MediaPlayerStateMachine which runns in a separate Thread.
      */
     void loadCameraDevice(CameraConfiguration conf);
+    /**
+     * Emit the URI of a stream source, e.g. "synthetic:?fps=100". This signal
+     * will be received by the MediaPlayerStateMachine which runns in a
+     * separate Thread.
+     */
+    void loadStreamSource(std::string uri);
 
     /**
      * Emit a frame number. This signal will be received by the
@@ -75,6 +82,11 @@ Q_SIGNALS:
      * MediaPlayerStateMachine which runns in a separate Thread.
      */
     void playCommand();
+    /**
+     * Emit the command to play backwards. This signal will be received by the
+     * MediaPlayerStateMachine which runns in a separate Thread.
+     */
+    void playBackwardsCommand();
     /**
      * Emit stop command. This signal will be received by the
      * MediaPlayerStateMachine which runns in a separate Thread.
@@ -85,6 +97,12 @@ Q_SIGNALS:
      * MediaPlayerStateMachine which runns in a separate Thread.
      */
     void pauseCommand();
+    /**
+     * Emit the pixel format requested by the tracker. This signal will be
+     * received by the MediaPlayerStateMachine which runns in a separate
+     * Thread.
+     */
+    void pixelFormatCommand(PixelFormat format);
 
     /**
      * This SIGNAL will be emmited if a state operation should be executed.
@@ -101,9 +119,11 @@ Q_SIGNALS:
     void renderCurrentImage(cv::Mat mat, QString name);
     /**
      * This SIGNAL is only emmited if Tracking Is Active. The PluginLoader
-     * component will receive the cv::Mat and the current frame number.
+     * component will receive the cv::Mat and the current frame number, the
+     * exporters the timestamp of the frame in milliseconds (negative if
+     * unknown).
      */
-    void trackCurrentImage(cv::Mat mat, uint number);
+    void trackCurrentImage(cv::Mat mat, uint number, double timestamp);
     /**
      * This SIGNAL is only emmited if Tracking Is inactive. The core
      * visualization controller will receive the framenumber and will try to
@@ -121,6 +141,14 @@ Q_SIGNALS:
     void emitNextMediaInBatch(const std::string path);
     void emitNextMediaInBatchLoaded(const std::string path);
 
+    /**
+     * This SIGNAL is emmited once the background of the current video is
+     * known, see BackgroundService. Only with Config::Background. An empty
+     * background is emitted whenever the media changes, the previous one
+     * does not fit anymore.
+     */
+    void backgroundChanged(cv::Mat background);
+
 public:
     void setTrackingActive();
     void setTrackingDeactive();
@@ -143,6 +171,8 @@ public:
     size_t  getCurrentFrameNumber();
     double  getFpsOfSourceFile();
     double  getCurrentFPS();
+    size_t  getFrameCacheHits();
+    size_t  getFrameCacheMisses();
     double  getTargetFPS();
     QString getCurrentFileName();
     cv::Mat getCurrentFrame();
@@ -176,6 +206,11 @@ public Q_SLOTS:
      */
     void rcvPauseState(bool state);
 
+private Q_SLOTS:
+    void receiveLoadVideoStream(std::vector<boost::filesystem::path> files);
+    void receiveLoadOtherMedia();
+    void receiveBackground(QString video, cv::Mat background);
+
 private:
     // TODO Refactor members to _ instead of m_
 
@@ -201,6 +236,8 @@ private:
     double  m_fpsOfSourceFile;
     double  m_currentFPS;
     double  m_targetFPS;
+    size_t  m_frameCacheHits;
+    size_t  m_frameCacheMisses;
     QString m_CurrentFilename;
     cv::Mat m_CurrentFrame;
 
@@ -226,6 +263,11 @@ private:
     bool    m_TrackingIsActive;
     QString m_NameOfCvMat = "Original";
 
+    // The videos loaded last, their backgrounds are provided once they are
+    // played
+    std::vector<boost::filesystem::path> m_VideoFiles;
+    QPointer<BackgroundService>          m_Background;
+
     std::chrono::system_clock::time_point start;
     std::chrono::system_clock::time_point end;
 };
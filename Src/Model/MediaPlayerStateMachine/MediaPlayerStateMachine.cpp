@@ -7,6 +7,7 @@
 #include "PlayerStates/PStateInitial.h"
 #include "PlayerStates/PStatePause.h"
 #include "PlayerStates/PStateStepBack.h"
+#include "PlayerStates/PStatePlayBack.h"
 #include "PlayerStates/PStateWait.h"
 #include "PlayerStates/PStateGoToFrame.h"
 
@@ -16,6 +17,7 @@
 MediaPlayerStateMachine::MediaPlayerStateMachine(QObject* parent)
 : IModel(parent)
 , m_ImageStream(BioTracker::Core::make_ImageStream3NoMedia())
+, m_pixelFormat(PixelFormat::BGR)
 {
     m_PlayerParameters = playerParameters();
 
@@ -31,6 +33,8 @@ MediaPlayerStateMachine::MediaPlayerStateMachine(QObject* parent)
                     (new PStatePause(this, m_ImageStream)));
     m_States.insert(IPlayerState::PLAYER_STATES::STATE_STEP_BACK,
                     (new PStateStepBack(this, m_ImageStream)));
+    m_States.insert(IPlayerState::PLAYER_STATES::STATE_PLAY_BACK,
+                    (new PStatePlayBack(this, m_ImageStream)));
     m_States.insert(IPlayerState::PLAYER_STATES::STATE_WAIT,
                     (new PStateWait(this, m_ImageStream)));
     m_States.insert(IPlayerState::PLAYER_STATES::STATE_GOTOFRAME,
@@ -70,6 +74,7 @@ void MediaPlayerStateMachine::receiveLoadVideoCommand(
 {
 
     m_stream = BioTracker::Core::make_ImageStream3Video(_cfg, files);
+    m_stream->setPixelFormat(m_pixelFormat);
 
     m_PlayerParameters.m_TotalNumbFrames = m_stream->numFrames();
 
@@ -84,6 +89,7 @@ void MediaPlayerStateMachine::receiveLoadPictures(
     std::vector<boost::filesystem::path> files)
 {
     m_stream = BioTracker::Core::make_ImageStream3Pictures(_cfg, files);
+    m_stream->setPixelFormat(m_pixelFormat);
 
     m_PlayerParameters.m_TotalNumbFrames = m_stream->numFrames();
 
@@ -102,6 +108,27 @@ void MediaPlayerStateMachine::receiveLoadCameraDevice(CameraConfiguration conf)
     }
 
     m_stream = BioTracker::Core::make_ImageStream3Camera(_cfg, conf);
+    m_stream->setPixelFormat(m_pixelFormat);
+
+    m_PlayerParameters.m_TotalNumbFrames = m_stream->numFrames();
+
+    for (auto x : m_States) {
+        x->changeImageStream(m_stream);
+    }
+
+    setNextState(IPlayerState::STATE_INITIAL_STREAM);
+}
+
+void MediaPlayerStateMachine::receiveLoadStreamSource(std::string uri)
+{
+    // Live sources may hold a device, release the old stream first
+    m_stream.reset();
+    for (auto x : m_States) {
+        x->changeImageStream(m_stream);
+    }
+
+    m_stream = BioTracker::Core::make_ImageStream3Source(_cfg, uri);
+    m_stream->setPixelFormat(m_pixelFormat);
 
     m_PlayerParameters.m_TotalNumbFrames = m_stream->numFrames();
 
@@ -137,6 +164,11 @@ void MediaPlayerStateMachine::receivePlayCommand()
     setNextState(IPlayerState::STATE_PLAY);
 }
 
+void MediaPlayerStateMachine::receivePlayBackwardsCommand()
+{
+    setNextState(IPlayerState::STATE_PLAY_BACK);
+}
+
 void MediaPlayerStateMachine::receiveGoToFrame(int frame)
 {
     PStateGoToFrame* state = dynamic_cast<PStateGoToFrame*>(
@@ -150,6 +182,16 @@ void MediaPlayerStateMachine::receiveTargetFps(double fps)
     m_PlayerParameters.m_fpsTarget = fps;
     static_cast<PStatePlay*>(m_States.value(IPlayerState::STATE_PLAY))
         ->setFps(fps);
+    static_cast<PStatePlayBack*>(
+        m_States.value(IPlayerState::STATE_PLAY_BACK))
+        ->setFps(fps);
+}
+
+void MediaPlayerStateMachine::receivePixelFormat(PixelFormat format)
+{
+    m_pixelFormat = format;
+    if (m_stream)
+        m_stream->setPixelFormat(format);
 }
 
 void MediaPlayerStateMachine::receivetoggleRecordImageStream()
@@ -182,8 +224,14 @@ void MediaPlayerStateMachine::updatePlayerParameter()
         m_CurrentPlayerState->getCurrentFrame();
     m_PlayerParameters.m_CurrentFrameNumber =
         m_CurrentPlayerState->getCurrentFrameNumber();
+    m_PlayerParameters.m_CurrentFrameTimestamp =
+        m_CurrentPlayerState->m_ImageStream->currentFrameTimestamp();
     m_PlayerParameters.m_fpsSourceVideo =
         m_CurrentPlayerState->m_ImageStream->fps();
+    m_PlayerParameters.m_frameCacheHits =
+        m_CurrentPlayerState->m_ImageStream->frameCacheHits();
+    m_PlayerParameters.m_frameCacheMisses =
+        m_CurrentPlayerState->m_ImageStream->frameCacheMisses();
     m_PlayerParameters.m_batchItems = m_CurrentPlayerState->getBatchItems();
 }
 
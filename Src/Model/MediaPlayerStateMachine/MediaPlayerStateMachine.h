@@ -49,7 +49,8 @@ public:
 
     void setConfig(Config* cfg)
     {
-        _cfg = cfg;
+        _cfg          = cfg;
+        m_pixelFormat = pixelFormatFromString(cfg->InputPixelFormat);
     };
 
 public Q_SLOTS:
@@ -62,14 +63,17 @@ public Q_SLOTS:
     void receiveLoadVideoCommand(std::vector<boost::filesystem::path> files);
     void receiveLoadPictures(std::vector<boost::filesystem::path> files);
     void receiveLoadCameraDevice(CameraConfiguration conf);
+    void receiveLoadStreamSource(std::string uri);
 
     void receivePrevFrameCommand();
     void receiveNextFramCommand();
     void receivePauseCommand();
     void receiveStopCommand();
     void receivePlayCommand();
+    void receivePlayBackwardsCommand();
     void receiveGoToFrame(int frame);
     void receiveTargetFps(double fps);
+    void receivePixelFormat(PixelFormat format);
 
     void receivetoggleRecordImageStream();
 
@@ -104,6 +108,7 @@ private:
     playerParameters                               m_PlayerParameters;
     std::shared_ptr<BioTracker::Core::ImageStream> m_stream;
     Config*                                        _cfg;
+    PixelFormat                                    m_pixelFormat;
 };
 
 #endif // BIOTRACKER3PLAYER_H
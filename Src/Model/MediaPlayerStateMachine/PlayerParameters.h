@@ -32,8 +32,12 @@ struct playerParameters
     std::string              m_CurrentTitle;
     size_t                   m_CurrentFrameNumber;
     std::optional<cv::Mat>   m_CurrentFrame;
+    // In milliseconds, negative if the stream does not know it
+    double                   m_CurrentFrameTimestamp;
     double                   m_fpsSourceVideo;
     double                   m_fpsTarget;
+    size_t                   m_frameCacheHits;
+    size_t                   m_frameCacheMisses;
     std::vector<std::string> m_batchItems;
 };
 
@@ -2,9 +2,6 @@
 #include "Model/MediaPlayerStateMachine/MediaPlayerStateMachine.h"
 #include "QTimer"
 
-#include <thread>
-using namespace std::chrono;
-
 PStatePlay::PStatePlay(
     MediaPlayerStateMachine*                       player,
     std::shared_ptr<BioTracker::Core::ImageStream> imageStream)
@@ -51,20 +48,8 @@ void PStatePlay::operate()
         nextState = IPlayerState::STATE_INITIAL_STREAM;
     }
 
-    // If fps is limited, wait the neccessary time
-    end = std::chrono::system_clock::now();
-    if (_targetFps > 0) {
-        long long dt = std::chrono::duration_cast<std::chrono::milliseconds>(
-                           end - start)
-                           .count();
-        long long targetFps = (1. / _targetFps) * 1000.;
-
-        if (dt < targetFps) {
-            std::this_thread::sleep_for(
-                std::chrono::milliseconds(targetFps - dt));
-        }
-    }
-    start = std::chrono::system_clock::now();
+    // If fps is limited, wait the necessary time
+    _pacer.wait();
 
     m_Player->setNextState(nextState);
 }
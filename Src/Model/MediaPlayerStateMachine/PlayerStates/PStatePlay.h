@@ -9,7 +9,7 @@
 #define PSTATEPLAY_H
 
 #include "IStates/IPlayerState.h"
-#include <chrono>
+#include "util/FramePacer.h"
 
 /**
  * This Stat is active when a video fiel is playing or a camera device is
@@ -25,7 +25,7 @@ public:
 
     void setFps(double fps)
     {
-        _targetFps = fps;
+        _pacer.setFps(fps);
     }
 
     // IPlayerState interface
@@ -33,8 +33,7 @@ public Q_SLOTS:
     void operate() override;
 
 private:
-    std::chrono::system_clock::time_point end, start;
-    double                                _targetFps = 0;
+    FramePacer _pacer;
 };
 
 #endif // PSTATEPLAY_H
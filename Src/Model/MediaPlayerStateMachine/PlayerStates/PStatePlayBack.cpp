@@ -0,0 +1,50 @@
+#include "PStatePlayBack.h"
+#include "Model/MediaPlayerStateMachine/MediaPlayerStateMachine.h"
+
+PStatePlayBack::PStatePlayBack(
+    MediaPlayerStateMachine*                       player,
+    std::shared_ptr<BioTracker::Core::ImageStream> imageStream)
+: IPlayerState(player, imageStream)
+{
+
+    m_StateParameters.m_Back = false;
+    m_StateParameters.m_Forw = false;
+    m_StateParameters.m_Paus = false;
+    m_StateParameters.m_Play = false;
+    m_StateParameters.m_Stop = false;
+    m_StateParameters.m_RecI = false;
+    m_StateParameters.m_RecO = false;
+
+    m_FrameNumber = 0;
+}
+
+void PStatePlayBack::operate()
+{
+
+    m_StateParameters.m_Play = true;
+    m_StateParameters.m_Forw = false;
+    m_StateParameters.m_Back = false;
+    m_StateParameters.m_Stop = true;
+    m_StateParameters.m_Paus = true;
+
+    IPlayerState::PLAYER_STATES nextState = IPlayerState::STATE_WAIT;
+
+    if (m_ImageStream->currentFrameNumber() > 0 &&
+        m_ImageStream->previousFrame(true)) {
+        m_Mat         = m_ImageStream->currentFrame();
+        m_FrameNumber = m_ImageStream->currentFrameNumber();
+        nextState     = IPlayerState::STATE_PLAY_BACK;
+    }
+
+    if (nextState == IPlayerState::STATE_WAIT) {
+        // Stopped at the first frame, as after pausing
+        m_StateParameters.m_Forw = true;
+        m_StateParameters.m_Back = m_ImageStream->currentFrameNumber() > 0;
+        m_StateParameters.m_Paus = false;
+    }
+
+    // If fps is limited, wait the necessary time
+    _pacer.wait();
+
+    m_Player->setNextState(nextState);
+}
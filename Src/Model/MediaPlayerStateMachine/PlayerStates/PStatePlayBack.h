@@ -0,0 +1,38 @@
+/****************************************************************************
+ **
+ ** This file is part of the BioTracker Framework
+ ** by Andreas Jörg
+ **
+ ****************************************************************************/
+
+#ifndef PSTATEPLAYBACK_H
+#define PSTATEPLAYBACK_H
+
+#include "IStates/IPlayerState.h"
+#include "util/FramePacer.h"
+
+/**
+ * This State is active while a video is played backwards. It steps to the
+ * previous frame until the first frame is reached, then STATE_WAIT is set as
+ * next state, otherwise STATE_PLAY_BACK.
+ */
+class PStatePlayBack : public IPlayerState
+{
+public:
+    PStatePlayBack(MediaPlayerStateMachine*                       player,
+                   std::shared_ptr<BioTracker::Core::ImageStream> imageStream);
+
+    void setFps(double fps)
+    {
+        _pacer.setFps(fps);
+    }
+
+    // IPlayerState interface
+public Q_SLOTS:
+    void operate() override;
+
+private:
+    FramePacer _pacer;
+};
+
+#endif // PSTATEPLAYBACK_H
@@ -1,4 +1,23 @@
 #include "TextureObject.h"
+#include "util/FramePool.h"
+
+namespace
+{
+    const int MinProxyWidth = 64;
+
+    // Proxies are a power of two fraction of the frame and at least as large
+    // as displayed, so that zooming only rederives the proxy once a step is
+    // crossed
+    double proxyScaleFor(const cv::Mat& frame, double displayScale)
+    {
+        double scale = 1;
+        while (scale / 2 >= displayScale &&
+               frame.cols * scale / 2 >= MinProxyWidth) {
+            scale /= 2;
+        }
+        return scale;
+    }
+}
 
 TextureObject::TextureObject(QObject* parent, QString name)
 : IModel(parent)
@@ -8,6 +27,7 @@ TextureObject::TextureObject(QObject* parent, QString name)
     // OpenGL originates in the lower left. Thus the image has to be flipped
     // vertically
     m_texture = QImage(1, 1, QImage::Format_RGB888);
+    m_source  = cv::Mat::zeros(1, 1, CV_8UC3);
 }
 
 void TextureObject::set(cv::Mat img)
@@ -16,12 +36,59 @@ void TextureObject::set(cv::Mat img)
         return;
     }
 
+    m_source = img;
+    render();
+}
+
+void TextureObject::setDisplayScale(double scale)
+{
+    m_displayScale = scale;
+    if (proxyScaleFor(m_source, m_displayScale) != m_proxyScale) {
+        render();
+    }
+}
+
+void TextureObject::render()
+{
+    // Proxies and conversions of every frame come from the frame pool, if
+    // the streams use one
+    cv::MatAllocator* allocator = FramePool::instance();
+    m_img.allocator             = allocator;
+
+    // Only the proxy is converted, the tracker keeps the full frame
+    m_proxyScale = proxyScaleFor(m_source, m_displayScale);
+    cv::Mat img;
+    img.allocator = allocator;
+    if (m_proxyScale < 1) {
+        cv::resize(m_source,
+                   img,
+                   cv::Size(),
+                   m_proxyScale,
+                   m_proxyScale,
+                   cv::INTER_AREA);
+    } else {
+        img = m_source;
+    }
+
+    if (img.type() == CV_8UC1) {
+        // 8 bit grayscale can be shown as it is
+        m_img     = img;
+        m_texture = QImage(m_img.data,
+                           m_img.cols,
+                           m_img.rows,
+                           static_cast<int>(m_img.step),
+                           QImage::Format_Grayscale8);
+        Q_EMIT notifyView();
+        return;
+    }
+
     if (img.channels() == 3) {
         img.convertTo(m_img, CV_8UC3);
         cv::cvtColor(m_img, m_img, cv::ColorConversionCodes::COLOR_BGR2RGB);
     } else if (img.channels() == 1) {
         // convert grayscale to "color"
         cv::Mat img8U;
+        img8U.allocator = allocator;
 
         // we assume that the 1d image has more than 8bit per pixel
         // (usually 64F) so we need to map a [HUGE range] to -> [0 .. 255]
@@ -19,6 +19,11 @@
  * cv::Mats to QImages. These QImages are then displayed in the
  * TextureObjectView. This class was adapted from the TextureObject class in
  * BioTracker 2.
+ *
+ * The QImage is a display proxy: frames larger than they appear on screen are
+ * downscaled before the conversion. width() and height() report the size of
+ * the original frame, which the view uses to map the proxy back onto image
+ * coordinates.
  */
 class TextureObject : public IModel
 {
@@ -29,23 +34,34 @@ public:
     void    set(cv::Mat img);
     QString getName();
 
+    /**
+     * Sets the zoom of the view, i.e. screen pixels per image pixel. The
+     * proxy is rederived from the last frame when its resolution changes.
+     */
+    void setDisplayScale(double scale);
+
     QImage const& get() const
     {
         return m_texture;
     }
     int width() const
     {
-        return m_texture.width();
+        return m_source.cols;
     }
     int height() const
     {
-        return m_texture.height();
+        return m_source.rows;
     }
 
 private:
+    void render();
+
     QString m_Name;
+    cv::Mat m_source;
     cv::Mat m_img;
     QImage  m_texture;
+    double  m_displayScale = 1;
+    double  m_proxyScale   = 1;
 };
 
 #endif // BIOTRACKER3TEXTUREOBJECT_H
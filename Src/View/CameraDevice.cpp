@@ -1,9 +1,10 @@
 #include "CameraDevice.h"
 #include "ui_CameraDevice.h"
 
-#include "QCameraInfo"
+#include "QTimer"
 #include "util/types.h"
 #include "util/camera/base.h"
+#include "util/CameraProbe.h"
 #if HAS_PYLON
     #include "util/camera/pylon.h"
 #endif
@@ -11,6 +12,42 @@
 #include <opencv2/opencv.hpp>
 #include "opencv2/highgui/highgui.hpp"
 
+namespace
+{
+    const int PreviewPollInterval = 50;
+
+    /**
+     * Opens the camera of conf and grabs a frame, on the calling thread.
+     * @return an empty image if the camera did not open or deliver in time.
+     */
+    cv::Mat grabPreview(const CameraConfiguration& conf,
+                        std::chrono::milliseconds  timeout)
+    {
+        auto capture = CameraProbe::open(conf._selector, timeout);
+        if (!capture) {
+            return cv::Mat();
+        }
+
+        if (conf._width != -1)
+            capture->set(cv::CAP_PROP_FRAME_WIDTH, conf._width);
+        if (conf._height != -1)
+            capture->set(cv::CAP_PROP_FRAME_HEIGHT, conf._height);
+        if (conf._fps != -1)
+            capture->set(cv::CAP_PROP_FPS, conf._fps);
+
+        if (!CameraProbe::waitForFrame(*capture, timeout)) {
+            return cv::Mat();
+        }
+
+        cv::Mat mat;
+        for (auto i = 0; i < 10; ++i) {
+            capture->grab();
+            capture->retrieve(mat);
+        }
+        return mat;
+    }
+}
+
 CameraDevice::CameraDevice(QWidget* parent)
 : QWidget(parent)
 , ui(new Ui::CameraDevice)
@@ -20,6 +57,12 @@ CameraDevice::CameraDevice(QWidget* parent)
 
     this->setAttribute(Qt::WA_DeleteOnClose);
 
+    // Listed right away, capabilities of new cameras follow when probed
+    connect(&CameraProbe::instance(),
+            &CameraProbe::devicesProbed,
+            this,
+            &CameraDevice::listAllCameras);
+    CameraProbe::instance().refresh();
     listAllCameras();
 }
 
@@ -56,56 +99,18 @@ void CameraDevice::on_showPreviewButton_clicked()
 {
     auto conf = grabUICameraConfiguration();
 
-    cv::Mat image;
     switch (conf._selector.type) {
     case CameraType::OpenCV: {
-        if (conf._selector.index == cv::CAP_XIAPI) {
-            m_capture.open(cv::CAP_XIAPI);
-        } else {
-            m_capture.open(conf._selector.name);
-        }
-
-        for (auto num_tries = 0; !m_capture.isOpened() && num_tries < 50;
-             ++num_tries)
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
-
-        if (conf._width != -1)
-            m_capture.set(cv::CAP_PROP_FRAME_WIDTH, conf._width);
-        if (conf._height != -1)
-            m_capture.set(cv::CAP_PROP_FRAME_HEIGHT, conf._height);
-        if (conf._fps != -1)
-            m_capture.set(cv::CAP_PROP_FPS, conf._fps);
-
-        if (!m_capture.isOpened()) {
-            ui->label_NoImage->setText("Error loading camera");
-            return;
-        }
-
-        cv::Mat mat;
-        for (auto i = 0; i < 10; ++i) {
-            m_capture.grab();
-            m_capture.retrieve(mat);
-        }
-
-        auto height = conf._height != -1 ? conf._height
-                                         : ui->label_NoImage->height();
-        auto ar     = mat.rows ? static_cast<float>(mat.cols) / mat.rows : 1;
-        auto width  = conf._width != -1 ? conf._width
-                                        : static_cast<int>(height * ar);
-
-        cv::Mat scaled;
-        cv::resize(mat, scaled, cv::Size{width, height});
-        if (scaled.type() == CV_8UC1)
-            cv::cvtColor(scaled, scaled, cv::COLOR_GRAY2RGB);
-        cv::cvtColor(scaled, scaled, cv::COLOR_BGR2RGB);
-
-        ui->label_NoImage->setPixmap(
-            QPixmap::fromImage(QImage(scaled.data,
-                                      scaled.cols,
-                                      scaled.rows,
-                                      static_cast<int>(scaled.step1()),
-                                      QImage::Format_RGB888)));
-        m_capture.release();
+        ui->label_NoImage->setText("Opening camera...");
+        ui->showPreviewButton->setEnabled(false);
+
+        auto preview       = std::make_shared<std::promise<cv::Mat>>();
+        m_preview          = preview->get_future();
+        const auto timeout = CameraProbe::instance().timeout();
+        std::thread([preview, conf, timeout] {
+            preview->set_value(grabPreview(conf, timeout));
+        }).detach();
+        pollPreview(conf);
         break;
     }
 #if HAS_PYLON
@@ -150,47 +155,81 @@ void CameraDevice::on_showPreviewButton_clicked()
     }
 }
 
-void CameraDevice::on_comboBox_currentIndexChanged(int index)
+void CameraDevice::pollPreview(CameraConfiguration conf)
 {
+    if (m_preview.wait_for(std::chrono::seconds(0)) !=
+        std::future_status::ready) {
+        QTimer::singleShot(PreviewPollInterval, this, [this, conf] {
+            pollPreview(conf);
+        });
+        return;
+    }
+    ui->showPreviewButton->setEnabled(true);
+    showPreview(m_preview.get(), conf);
 }
 
-void CameraDevice::listAllCameras()
+void CameraDevice::showPreview(cv::Mat mat, const CameraConfiguration& conf)
 {
-    cameras = QCameraInfo::availableCameras();
-    for (int index = 0; index < cameras.size(); ++index) {
-        ui->comboBox->addItem(cameras[index].description(),
-                              QVariant::fromValue(CameraSelector{
-                                  CameraType::OpenCV,
-                                  index,
-                                  cameras[index].deviceName().toStdString()}));
+    if (mat.empty()) {
+        ui->label_NoImage->setText("Error loading camera");
+        return;
     }
 
-    {
-        cv::VideoCapture ximea_camera(cv::CAP_XIAPI);
-        if (ximea_camera.isOpened()) {
-            ui->comboBox->addItem(
-                "XIMEA default",
-                QVariant::fromValue(
-                    CameraSelector{CameraType::OpenCV, cv::CAP_XIAPI, ""}));
-        }
-    }
-
-#if HAS_PYLON
-    {
-        Pylon::PylonAutoInitTerm pylon;
+    auto height = conf._height != -1 ? conf._height
+                                     : ui->label_NoImage->height();
+    auto ar     = mat.rows ? static_cast<float>(mat.cols) / mat.rows : 1;
+    auto width  = conf._width != -1 ? conf._width
+                                    : static_cast<int>(height * ar);
+
+    cv::Mat scaled;
+    cv::resize(mat, scaled, cv::Size{width, height});
+    if (scaled.type() == CV_8UC1)
+        cv::cvtColor(scaled, scaled, cv::COLOR_GRAY2RGB);
+    cv::cvtColor(scaled, scaled, cv::COLOR_BGR2RGB);
+
+    ui->label_NoImage->setPixmap(
+        QPixmap::fromImage(QImage(scaled.data,
+                                  scaled.cols,
+                                  scaled.rows,
+                                  static_cast<int>(scaled.step1()),
+                                  QImage::Format_RGB888)));
+}
 
-        auto&                   factory = Pylon::CTlFactory::GetInstance();
-        Pylon::DeviceInfoList_t devices;
-        factory.EnumerateDevices(devices);
+void CameraDevice::on_comboBox_currentIndexChanged(int index)
+{
+    // The supported modes of the camera, as far as they are probed yet
+    const QString modes = ui->comboBox->itemData(index, Qt::ToolTipRole)
+                              .toString();
+    ui->lineEdit->setToolTip(modes);
+    ui->lineEdit_2->setToolTip(modes);
+    ui->lineEdit_3->setToolTip(modes);
+}
 
-        for (int index = 0; index < devices.size(); ++index) {
-            ui->comboBox->addItem(
-                QString{devices[index].GetFriendlyName()},
-                QVariant::fromValue(
-                    CameraSelector{CameraType::Pylon, index, ""}));
+void CameraDevice::listAllCameras()
+{
+    const QString selected = ui->comboBox->currentText();
+    ui->comboBox->clear();
+    for (const auto& device : CameraProbe::instance().devices()) {
+        QStringList modes;
+        for (const auto& mode : device.modes) {
+            modes << QString("%1 x %2 @ %3 fps")
+                         .arg(mode.width)
+                         .arg(mode.height)
+                         .arg(mode.fps);
         }
+        ui->comboBox->addItem(device.description,
+                              QVariant::fromValue(device.selector));
+        ui->comboBox->setItemData(ui->comboBox->count() - 1,
+                                  modes.isEmpty() ? "Not probed yet"
+                                                  : modes.join("\n"),
+                                  Qt::ToolTipRole);
     }
-#endif
+
+    const int index = ui->comboBox->findText(selected);
+    if (index >= 0) {
+        ui->comboBox->setCurrentIndex(index);
+    }
+    on_comboBox_currentIndexChanged(ui->comboBox->currentIndex());
 }
 
 void CameraDevice::on_buttonBox_rejected()
@@ -10,6 +10,8 @@
 #include "util/camera/base.h"
 #include <opencv2/opencv.hpp>
 
+#include <future>
+
 namespace Ui
 {
     class CameraDevice;
@@ -38,16 +40,18 @@ Q_SIGNALS:
 private:
     CameraConfiguration grabUICameraConfiguration();
     void                listAllCameras();
+    void                pollPreview(CameraConfiguration conf);
+    void                showPreview(cv::Mat                    mat,
+                                    const CameraConfiguration& conf);
 
 private:
     Ui::CameraDevice* ui;
-    cv::VideoCapture  m_capture;
+    // Grabbed on a thread of its own, so the dialog stays responsive
+    std::future<cv::Mat> m_preview;
 
     QPointer<QCamera>           camera;
     QPointer<QCameraViewfinder> viewfinder;
 
-    QList<QCameraInfo> cameras;
-
     int m_ximeaId;
 };
 
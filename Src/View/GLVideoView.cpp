@@ -42,7 +42,7 @@ void GLVideoView::paintGL()
     painter.setViewport(viewport);
 
     QRectF target(0, 0, textureObject->width(), textureObject->height());
-    QRectF source(0, 0, textureObject->width(), textureObject->height());
+    QRectF source(img.rect());
 
     painter.drawImage(target, img, source);
     QPainter p(this);
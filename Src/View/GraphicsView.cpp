@@ -51,6 +51,17 @@ void GraphicsView::addPixmapItem(QGraphicsItem* item)
     update();
 }
 
+void GraphicsView::fitImage(const QRectF& rect)
+{
+    fitInView(rect, Qt::KeepAspectRatio);
+    emit(onZoomChanged(zoom()));
+}
+
+qreal GraphicsView::zoom() const
+{
+    return transform().m11() * devicePixelRatioF();
+}
+
 void GraphicsView::getNotified()
 {
 }
@@ -68,6 +79,7 @@ void GraphicsView::wheelEvent(QWheelEvent* event)
         } else {
             scale(0.9, 0.9);
         }
+        emit(onZoomChanged(zoom()));
     }
 }
 
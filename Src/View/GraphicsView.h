@@ -16,6 +16,16 @@ public:
     void addPixmapItem(QGraphicsItem* item);
     void removeGraphicsItem(QGraphicsItem* item);
 
+    /**
+     * Fits rect into the view, keeping the aspect ratio.
+     */
+    void fitImage(const QRectF& rect);
+
+    /**
+     * @return device pixels per scene unit, i.e. per image pixel.
+     */
+    qreal zoom() const;
+
     QGraphicsScene* m_GraphicsScene; // MARKER
 
     void mousePressEvent(QMouseEvent* event) override;
@@ -49,6 +59,8 @@ Q_SIGNALS:
     void onKeyPressEvent(QKeyEvent* event);
 
     void emitCursorPosition(QPoint pos);
+
+    void onZoomChanged(qreal zoom);
 };
 
 #endif // GRAPHICSVIEW_H
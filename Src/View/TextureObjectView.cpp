@@ -19,25 +19,31 @@ void TextureObjectView::getNotified()
     pma.convertFromImage(texture->get());
     setPixmap(pma);
 
+    // The texture may be a downscaled proxy, stretch it over the full frame
+    // so that scene coordinates stay image coordinates
+    setTransform(QTransform::fromScale(
+        static_cast<qreal>(texture->width()) / pma.width(),
+        static_cast<qreal>(texture->height()) / pma.height()));
+
     // if frame is set, set the boundingrect of the scene to the size of the
     // frame
     if (texture->height() > 1) {
         QGraphicsScene* scene = this->scene();
 
-        QRectF currentBoundingRect = this->boundingRect();
+        QRectF currentBoundingRect = this->sceneBoundingRect();
 
         // check if bounding rect changed -> this means that a new video has
         // been loaded, right?
         if (currentBoundingRect != _oldBoundingRect) {
+            _oldBoundingRect = currentBoundingRect;
+
             QRectF boundingWithMargins = currentBoundingRect.marginsAdded(
                 QMarginsF(150, 150, 150, 150));
             scene->setSceneRect(boundingWithMargins);
 
             GraphicsView* view = dynamic_cast<GraphicsView*>(
                 scene->views()[0]);
-            view->fitInView(boundingWithMargins, Qt::KeepAspectRatio);
-
-            _oldBoundingRect = currentBoundingRect;
+            view->fitImage(boundingWithMargins);
         }
     }
     update();
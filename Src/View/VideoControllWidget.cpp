@@ -57,6 +57,7 @@ void VideoControllWidget::getNotified()
 
     ui->actionNext_frame->setEnabled(mediaPlayer->getForwardState());
     ui->actionPrev_frame->setEnabled(mediaPlayer->getBackwardState());
+    ui->actionPlay_backwards->setEnabled(mediaPlayer->getBackwardState());
     ui->actionPlay_Pause->setEnabled(mediaPlayer->getPlayState());
     ui->actionStop->setEnabled(mediaPlayer->getStopState());
 
@@ -108,6 +109,15 @@ void VideoControllWidget::getNotified()
         ui->lcd_currentFpsNum->display(fps);
         lastFpsSet = now;
 
+        const size_t hits   = mediaPlayer->getFrameCacheHits();
+        const size_t misses = mediaPlayer->getFrameCacheMisses();
+        if (hits + misses > 0) {
+            ui->lcd_currentFpsNum->setToolTip(
+                QString("Frame cache: %1 hits, %2 misses")
+                    .arg(hits)
+                    .arg(misses));
+        }
+
         // for average fps calculation
         _fpsSum += fps;
         _fpsCounter += 1;
@@ -277,6 +287,12 @@ void VideoControllWidget::on_actionPrev_frame_triggered(bool checked)
         getController());
     controller->prevFrame();
 }
+void VideoControllWidget::on_actionPlay_backwards_triggered(bool checked)
+{
+    ControllerPlayer* controller = dynamic_cast<ControllerPlayer*>(
+        getController());
+    controller->playBackwards();
+}
 void VideoControllWidget::on_actionScreenshot_triggered(bool checked)
 {
     ControllerPlayer* controller = dynamic_cast<ControllerPlayer*>(
@@ -353,6 +369,8 @@ void VideoControllWidget::setupVideoToolbar()
 
             videoToolBar->addAction(ui->actionPrev_frame);
             videoToolBar->addSeparator();
+            videoToolBar->addAction(ui->actionPlay_backwards);
+            videoToolBar->addSeparator();
             videoToolBar->addAction(ui->actionPlay_Pause);
             videoToolBar->addSeparator();
             videoToolBar->addAction(ui->actionStop);
@@ -68,6 +68,7 @@ private Q_SLOTS:
     void on_actionStop_triggered(bool checked = false);
     void on_actionNext_frame_triggered(bool checked = false);
     void on_actionPrev_frame_triggered(bool checked = false);
+    void on_actionPlay_backwards_triggered(bool checked = false);
     void on_actionScreenshot_triggered(bool checked = false);
     void on_actionRecord_cam_triggered(bool checked = false);
     void on_actionRecord_all_triggered(bool checked = false);
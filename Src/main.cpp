@@ -14,7 +14,11 @@
 #include "util/CLIcommands.h"
 #include "Interfaces/IModel/IModelTrackedComponent.h"
 #include "util/Config.h"
+#include "util/PixelFormat.h"
+#include "util/CameraProbe.h"
+#include "util/FramePool.h"
 #include <QDir>
+#include <QDebug>
 
 #include <boost/filesystem.hpp>
 
@@ -84,6 +88,7 @@ int main(int argc, char* argv[])
     qRegisterMetaType<cv::Mat>("cv::Mat");
     qRegisterMetaType<std::size_t>("std::size_t");
     qRegisterMetaType<size_t>("size_t");
+    qRegisterMetaType<std::string>("std::string");
     qRegisterMetaType<std::vector<boost::filesystem::path>>(
         "std::vector<boost::filesystem::path>");
     qRegisterMetaType<BiotrackerTypes::AreaType>("BiotrackerTypes::AreaType");
@@ -93,6 +98,7 @@ int main(int argc, char* argv[])
     qRegisterMetaType<std::shared_ptr<const playerParameters>>(
         "std::shared_ptr<const playerParameters>");
     qRegisterMetaType<CameraConfiguration>("CameraConfiguration");
+    qRegisterMetaType<PixelFormat>("PixelFormat");
     qRegisterMetaTypeStreamOperators<QList<IModelTrackedComponent*>>(
         "QList<IModelTrackedComponent*>");
 
@@ -108,10 +114,26 @@ int main(int argc, char* argv[])
     qd.mkpath(cfg->DirScreenshots);
     qd.mkpath(cfg->DirTemp);
 
+    // Probed in the background, so that choosing a camera does not wait
+    CameraProbe::instance().setTimeout(
+        std::chrono::milliseconds(std::max(0, cfg->CameraOpenTimeout)));
+    if (cfg->ProbeCameras) {
+        CameraProbe::instance().refresh();
+    }
+
     BioTracker3App bioTracker3(&app);
     GuiContext     context(&bioTracker3, cfg);
     bioTracker3.setBioTrackerContext(&context);
     bioTracker3.runBioTracker();
 
     app.exec();
+
+    // The pool is shared by all streams, so it is reported once per run
+    const FramePool* pool = FramePool::instance();
+    if (pool && pool->hits() + pool->misses() > 0) {
+        qDebug() << "Frame pool:"
+                 << 100.0 * pool->hits() / (pool->hits() + pool->misses())
+                 << "% hits," << pool->pooledBytes() / (1024 * 1024)
+                 << "MB pooled";
+    }
 }
@@ -0,0 +1,154 @@
+/**
+ * Reference producer for the shared memory stream source: publishes frames
+ * of a video, or a moving test pattern, into a SharedFrameRing.
+ *
+ *   biotracker-shm-producer --name cam0 --width 1280 --height 720 --fps 50
+ *   BioTracker --source shm:cam0
+ */
+
+#include "util/SharedFrameRing.h"
+
+#include <boost/program_options.hpp>
+#include <opencv2/opencv.hpp>
+
+#include <chrono>
+#include <csignal>
+#include <iostream>
+#include <thread>
+
+namespace
+{
+    volatile std::sig_atomic_t stop = 0;
+
+    void onSignal(int)
+    {
+        stop = 1;
+    }
+
+    cv::Mat pattern(int width, int height, bool gray, std::uint64_t frame)
+    {
+        cv::Mat image(height, width, gray ? CV_8UC1 : CV_8UC3);
+        image.setTo(cv::Scalar(48, 48, 48));
+        const int x = static_cast<int>(frame * 4 % width);
+        cv::rectangle(image,
+                      cv::Rect(x, 0, std::max(1, width / 20), height),
+                      cv::Scalar(255, 255, 255),
+                      cv::FILLED);
+        cv::putText(image,
+                    std::to_string(frame),
+                    cv::Point(20, 60),
+                    cv::FONT_HERSHEY_SIMPLEX,
+                    2,
+                    cv::Scalar(0, 255, 0),
+                    3);
+        return image;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    namespace po = boost::program_options;
+
+    std::string name;
+    std::string video;
+    int         width, height, slots;
+    double      fps;
+    po::options_description options("Options");
+    options.add_options()("help", "Produce this help message")(
+        "name",
+        po::value<std::string>(&name)->default_value("biotracker"),
+        "Name of the shared memory")(
+        "video",
+        po::value<std::string>(&video),
+        "Publish the frames of a video instead of a test pattern")(
+        "width",
+        po::value<int>(&width)->default_value(1280),
+        "Width of the test pattern")(
+        "height",
+        po::value<int>(&height)->default_value(720),
+        "Height of the test pattern")(
+        "fps",
+        po::value<double>(&fps)->default_value(30),
+        "Frames per second")(
+        "slots",
+        po::value<int>(&slots)->default_value(8),
+        "Number of frames in the ring")("gray", "Publish grayscale frames");
+
+    po::variables_map vm;
+    try {
+        po::store(po::parse_command_line(argc, argv, options), vm);
+        po::notify(vm);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n" << options;
+        return 1;
+    }
+    if (vm.count("help")) {
+        std::cout << options;
+        return 0;
+    }
+    const bool gray = vm.count("gray") > 0;
+
+    cv::VideoCapture capture;
+    if (!video.empty()) {
+        if (!capture.open(video)) {
+            std::cerr << "Unable to open " << video << "\n";
+            return 1;
+        }
+        width  = static_cast<int>(capture.get(cv::CAP_PROP_FRAME_WIDTH));
+        height = static_cast<int>(capture.get(cv::CAP_PROP_FRAME_HEIGHT));
+    }
+    if (width <= 0 || height <= 0 || fps <= 0 || slots < 2) {
+        std::cerr << "Invalid frame size, rate or slot count\n";
+        return 1;
+    }
+
+    const std::uint64_t frameBytes = static_cast<std::uint64_t>(width) *
+                                     height * (gray ? 1 : 3);
+    auto ring = SharedFrameRing::create(name, slots, frameBytes, fps);
+    if (!ring) {
+        std::cerr << "Unable to create shared memory " << name << "\n";
+        return 1;
+    }
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+    std::cout << "Publishing " << width << "x" << height << " at " << fps
+              << " fps to " << name << ", stop with Ctrl+C\n";
+
+    using Clock         = std::chrono::steady_clock;
+    const auto interval = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(1 / fps));
+    auto          due    = Clock::now();
+    auto          report = due + std::chrono::seconds(1);
+    std::uint64_t frame  = 0;
+    while (!stop) {
+        cv::Mat image;
+        if (capture.isOpened()) {
+            if (!capture.read(image)) {
+                // Loop the video
+                capture.set(cv::CAP_PROP_POS_FRAMES, 0);
+                continue;
+            }
+            if (gray) {
+                cv::cvtColor(image, image, cv::COLOR_BGR2GRAY);
+            }
+        } else {
+            image = pattern(width, height, gray, frame);
+        }
+
+        std::this_thread::sleep_until(due);
+        due += interval;
+        const auto now = Clock::now();
+        ring->publish(image,
+                      std::chrono::duration_cast<std::chrono::nanoseconds>(
+                          now.time_since_epoch())
+                          .count());
+        frame++;
+
+        if (now >= report) {
+            std::cout << ring->published() << " published, "
+                      << ring->dropped() << " dropped\n";
+            report += std::chrono::seconds(1);
+        }
+    }
+    return 0;
+}
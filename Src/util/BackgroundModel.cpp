@@ -0,0 +1,266 @@
+#include "BackgroundModel.h"
+#include "ThreadPool.h"
+#include "VideoIndex.h"
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <set>
+
+const int BackgroundModel::MaxSamples;
+
+namespace
+{
+    const Sidecar::Magic Magic     = {'B', 'T', 'B', 'G', 'N', 'D', '0', '1'};
+    const char*          Extension = ".background";
+
+    const int Bins = 16;
+
+    /**
+     * Frames spread evenly over the video, the anchors closest before them
+     * if the index is known.
+     */
+    std::vector<std::size_t> samplePositions(
+        const boost::filesystem::path& video,
+        const VideoIndex*              index,
+        int                            samples)
+    {
+        std::size_t frames;
+        if (index) {
+            frames = index->frameCount();
+        } else {
+            cv::VideoCapture capture(video.string());
+            frames = static_cast<std::size_t>(
+                std::max(0.0, capture.get(cv::CAP_PROP_FRAME_COUNT)));
+        }
+
+        std::set<std::size_t> positions;
+        for (int i = 0; i < samples && frames > 0; i++) {
+            const std::size_t frame = (2 * i + 1) * frames / (2 * samples);
+            positions.insert(index ? index->anchorBefore(frame) : frame);
+        }
+        return std::vector<std::size_t>(positions.begin(), positions.end());
+    }
+
+    /**
+     * Decodes the frames at positions on the workers, in batches of one
+     * frame per worker, and hands them to accumulate in order. Each worker
+     * owns a capture which only seeks forward.
+     * @return the number of frames accumulate took.
+     */
+    std::size_t decodeSamples(
+        const boost::filesystem::path&                 video,
+        const VideoIndex*                              index,
+        const std::vector<std::size_t>&                positions,
+        ThreadPool&                                    pool,
+        const std::atomic<bool>&                       abort,
+        const std::function<bool(const cv::Mat& frame)>& accumulate)
+    {
+        std::vector<cv::VideoCapture> captures(pool.size());
+        std::size_t                   decoded = 0;
+        for (std::size_t batch = 0; batch < positions.size() && !abort;
+             batch += captures.size()) {
+            std::vector<std::future<cv::Mat>> frames;
+            for (std::size_t i = 0;
+                 i < captures.size() && batch + i < positions.size();
+                 i++) {
+                cv::VideoCapture& capture  = captures[i];
+                const std::size_t position = positions[batch + i];
+                frames.push_back(pool.submit([&video,
+                                              index,
+                                              &capture,
+                                              position] {
+                    if (!capture.isOpened() && !capture.open(video.string())) {
+                        return cv::Mat();
+                    }
+                    if (index) {
+                        capture.set(cv::CAP_PROP_POS_MSEC,
+                                    index->timestamp(position));
+                    } else {
+                        capture.set(cv::CAP_PROP_POS_FRAMES,
+                                    static_cast<double>(position));
+                    }
+                    cv::Mat frame;
+                    capture.read(frame);
+                    return frame;
+                }));
+            }
+            for (auto& frame : frames) {
+                const cv::Mat image = frame.get();
+                if (!image.empty() && accumulate(image)) {
+                    decoded++;
+                }
+            }
+        }
+        return decoded;
+    }
+}
+
+std::shared_ptr<BackgroundModel> BackgroundModel::load(
+    const boost::filesystem::path& video,
+    int                            samples,
+    const boost::filesystem::path& directory)
+{
+    auto                        model = std::make_shared<BackgroundModel>();
+    boost::filesystem::ifstream in;
+    if (!Sidecar::stamp(video, model->_stamp) ||
+        !Sidecar::open(in,
+                       Sidecar::path(video, directory, Extension),
+                       Magic,
+                       model->_stamp)) {
+        return nullptr;
+    }
+
+    if (!Sidecar::read(in, model->_samples) ||
+        model->_samples != std::min(samples, MaxSamples)) {
+        return nullptr;
+    }
+
+    // The image follows as PNG
+    const std::vector<std::uint8_t> png(
+        (std::istreambuf_iterator<char>(in)),
+        std::istreambuf_iterator<char>());
+    model->_video = boost::filesystem::absolute(video);
+    model->_image = cv::imdecode(png, cv::IMREAD_UNCHANGED);
+    if (model->_image.empty()) {
+        return nullptr;
+    }
+    return model;
+}
+
+std::shared_ptr<BackgroundModel> BackgroundModel::build(
+    const boost::filesystem::path&    video,
+    std::shared_ptr<const VideoIndex> index,
+    int                               samples,
+    std::size_t                       threads,
+    const std::atomic<bool>&          abort)
+{
+    auto model      = std::make_shared<BackgroundModel>();
+    model->_video   = boost::filesystem::absolute(video);
+    model->_samples = std::max(1, std::min(samples, MaxSamples));
+    if (!Sidecar::stamp(video, model->_stamp)) {
+        return nullptr;
+    }
+
+    const std::vector<std::size_t> positions = samplePositions(
+        video,
+        index.get(),
+        model->_samples);
+    ThreadPool pool(threads);
+
+    // Per value of each pixel and channel: the histogram of the current
+    // pass, the bin holding the median and the median's rank in the bin
+    cv::Mat                   layout;
+    std::vector<std::uint8_t> histogram;
+    std::vector<std::uint8_t> medianBin;
+    std::vector<std::uint8_t> medianRank;
+
+    const auto accumulate = [&layout, &histogram, &medianBin](
+                                const cv::Mat& frame,
+                                bool           fine) {
+        if (frame.size() != layout.size() || frame.type() != layout.type()) {
+            return false;
+        }
+        // Rows are disjoint, the workers never count into the same bins
+        const int values = frame.cols * frame.channels();
+        cv::parallel_for_(
+            cv::Range(0, frame.rows),
+            [&](const cv::Range& rows) {
+                for (int y = rows.start; y < rows.end; y++) {
+                    const std::uint8_t* src   = frame.ptr<std::uint8_t>(y);
+                    const std::size_t   first = static_cast<std::size_t>(y) *
+                                              values;
+                    for (int x = 0; x < values; x++) {
+                        const std::size_t p = first + x;
+                        if (!fine) {
+                            histogram[p * Bins + (src[x] >> 4)]++;
+                        } else if ((src[x] >> 4) == medianBin[p]) {
+                            histogram[p * Bins + (src[x] & 15)]++;
+                        }
+                    }
+                }
+            });
+        return true;
+    };
+
+    // Coarse pass, allocates on the first frame
+    const std::size_t coarse = decodeSamples(
+        video,
+        index.get(),
+        positions,
+        pool,
+        abort,
+        [&](const cv::Mat& frame) {
+            if (layout.empty()) {
+                if (frame.depth() != CV_8U) {
+                    return false;
+                }
+                layout = cv::Mat(frame.size(), frame.type());
+                histogram.assign(frame.total() * frame.channels() * Bins, 0);
+            }
+            return accumulate(frame, false);
+        });
+    if (abort || coarse == 0 || layout.empty()) {
+        return nullptr;
+    }
+
+    const std::size_t values = layout.total() * layout.channels();
+    const std::size_t rank   = (coarse - 1) / 2;
+    medianBin.resize(values);
+    medianRank.resize(values);
+    for (std::size_t p = 0; p < values; p++) {
+        const std::uint8_t* bins  = &histogram[p * Bins];
+        std::size_t         count = 0;
+        int                 bin   = 0;
+        while (bin < Bins - 1 && count + bins[bin] <= rank) {
+            count += bins[bin];
+            bin++;
+        }
+        medianBin[p]  = static_cast<std::uint8_t>(bin);
+        medianRank[p] = static_cast<std::uint8_t>(rank - count);
+    }
+    std::fill(histogram.begin(), histogram.end(), 0);
+
+    // Fine pass over the same frames
+    const std::size_t fine = decodeSamples(
+        video,
+        index.get(),
+        positions,
+        pool,
+        abort,
+        [&](const cv::Mat& frame) { return accumulate(frame, true); });
+    if (abort || fine != coarse) {
+        return nullptr;
+    }
+
+    model->_image = cv::Mat(layout.size(), layout.type());
+    std::uint8_t* dst = model->_image.ptr<std::uint8_t>();
+    for (std::size_t p = 0; p < values; p++) {
+        const std::uint8_t* bins  = &histogram[p * Bins];
+        std::size_t         count = 0;
+        int                 value = 0;
+        while (value < Bins - 1 && count + bins[value] <= medianRank[p]) {
+            count += bins[value];
+            value++;
+        }
+        dst[p] = static_cast<std::uint8_t>(medianBin[p] * Bins + value);
+    }
+    return model;
+}
+
+bool BackgroundModel::save(const boost::filesystem::path& directory) const
+{
+    std::vector<std::uint8_t> png;
+    if (_image.empty() || !cv::imencode(".png", _image, png)) {
+        return false;
+    }
+
+    return Sidecar::save(
+        Sidecar::path(_video, directory, Extension),
+        Magic,
+        _stamp,
+        [this, &png](std::ostream& out) {
+            Sidecar::write(out, _samples);
+            out.write(reinterpret_cast<const char*>(png.data()), png.size());
+        });
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "Sidecar.h"
+
+#include <opencv2/opencv.hpp>
+#include <boost/filesystem.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class VideoIndex;
+
+/**
+ * Median background of a video, computed from frames sampled evenly over the
+ * whole video, e.g. for trackers subtracting the background.
+ *
+ * The per pixel median is found in two passes over the samples with 16 bin
+ * histograms: the first pass finds the bin holding the median, the second
+ * one its exact value within the bin. Memory is bounded by 18 bytes per
+ * pixel and channel, independent of the number of samples.
+ *
+ * Computing the model decodes all samples twice, so it is stored as a
+ * sidecar and reused as long as the video does not change.
+ */
+class BackgroundModel
+{
+public:
+    /**
+     * Histogram counts are 8 bit.
+     */
+    static const int MaxSamples = 255;
+
+    /**
+     * @return the model of video from samples frames stored in directory,
+     * or nullptr if there is none or it is outdated.
+     */
+    static std::shared_ptr<BackgroundModel> load(
+        const boost::filesystem::path& video,
+        int                            samples,
+        const boost::filesystem::path& directory);
+
+    /**
+     * Computes the model from samples frames, decoded on threads workers (0
+     * selects the number of hardware threads). With a seek index the
+     * samples are keyframes, which decode fastest. Returns nullptr if
+     * aborted or no frame could be decoded.
+     */
+    static std::shared_ptr<BackgroundModel> build(
+        const boost::filesystem::path&    video,
+        std::shared_ptr<const VideoIndex> index,
+        int                               samples,
+        std::size_t                       threads,
+        const std::atomic<bool>&          abort);
+
+    /**
+     * Writes the model as sidecar for its video into directory.
+     */
+    bool save(const boost::filesystem::path& directory) const;
+
+    const cv::Mat& image() const
+    {
+        return _image;
+    }
+
+private:
+    boost::filesystem::path _video;
+    Sidecar::Stamp          _stamp;
+    std::int32_t            _samples = 0;
+    cv::Mat                 _image;
+};
@@ -9,6 +9,8 @@
 #include <iostream>
 #include <fstream>
 #include <exception>
+#include <regex>
+#include <stdexcept>
 
 #include <qfile.h>
 #include <qfileinfo.h>
@@ -34,6 +36,16 @@ public:
                 "video",
                 value<std::string>(),
                 "Loads a video from given filepath")(
+                "source",
+                value<std::string>(),
+                "Loads a stream source from given URI, e.g. "
+                "synthetic:?width=1920&height=1080&fps=100&blobs=10")(
+                "stdin",
+                value<std::string>(),
+                "Reads raw frames from stdin, given as WxH@fps[:format] with "
+                "format bgr24 (default), bgra or gray, e.g. "
+                "ffmpeg -i in.mp4 -f rawvideo -pix_fmt bgr24 - | "
+                "BioTracker --stdin 1920x1080@30")(
                 "cfg",
                 value<std::string>(),
                 "Provide custom path to a config file");
@@ -76,6 +88,14 @@ public:
                 auto str       = vm["video"].as<std::string>();
                 cfg->LoadVideo = QString(str.c_str());
             }
+            if (vm.count("source")) {
+                auto str        = vm["source"].as<std::string>();
+                cfg->LoadSource = QString(str.c_str());
+            }
+            if (vm.count("stdin")) {
+                auto str        = vm["stdin"].as<std::string>();
+                cfg->LoadSource = stdinSource(str);
+            }
             if (vm.count("cfg")) {
                 auto str               = vm["cfg"].as<std::string>();
                 cfg->CfgCustomLocation = QString(str.c_str());
@@ -84,4 +104,27 @@ public:
             std::cout << e.what() << "\n";
         }
     }
+
+private:
+    /**
+     * @return the pipe: source URI reading stdin for a WxH@fps[:format]
+     * specification.
+     */
+    static QString stdinSource(const std::string& spec)
+    {
+        static const std::regex format(
+            "(\\d+)x(\\d+)@([0-9.]+)(?::(bgr24|bgra|gray))?");
+        std::smatch match;
+        if (!std::regex_match(spec, match, format)) {
+            throw std::invalid_argument("Invalid --stdin " + spec +
+                                        ", expected WxH@fps[:format]");
+        }
+        std::string uri = "pipe:-?width=" + match[1].str() +
+                          "&height=" + match[2].str() +
+                          "&fps=" + match[3].str();
+        if (match[4].matched) {
+            uri += "&format=" + match[4].str();
+        }
+        return QString::fromStdString(uri);
+    }
 };
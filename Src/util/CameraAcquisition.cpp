@@ -0,0 +1,71 @@
+#include "CameraAcquisition.h"
+
+CameraAcquisition::CameraAcquisition(std::size_t depth)
+: _ring(depth)
+, _abort(false)
+, _capture(nullptr)
+, _sequence(0)
+, _dropped(0)
+{
+}
+
+CameraAcquisition::~CameraAcquisition()
+{
+    stop();
+}
+
+void CameraAcquisition::start(cv::VideoCapture* capture)
+{
+    stop();
+
+    if (_started == std::chrono::steady_clock::time_point()) {
+        _started = std::chrono::steady_clock::now();
+    }
+    _capture = capture;
+    _abort   = false;
+    _ring.reset();
+    _thread = std::thread(&CameraAcquisition::run, this);
+}
+
+void CameraAcquisition::stop()
+{
+    _abort = true;
+    _ring.abort();
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+    _ring.reset();
+}
+
+bool CameraAcquisition::running() const
+{
+    return _thread.joinable();
+}
+
+std::optional<CapturedFrame> CameraAcquisition::pop()
+{
+    return _ring.pop();
+}
+
+void CameraAcquisition::run()
+{
+    while (!_abort) {
+        // Stamp between grab and retrieve, the conversion in retrieve may
+        // take longer than the frame interval
+        CapturedFrame frame;
+        if (!_capture->grab()) {
+            _ring.close();
+            return;
+        }
+        frame.captured = std::chrono::steady_clock::now();
+        frame.sequence = _sequence++;
+        if (!_capture->retrieve(frame.image) || frame.image.empty()) {
+            _ring.close();
+            return;
+        }
+
+        if (_ring.pushOverwrite(std::move(frame))) {
+            _dropped++;
+        }
+    }
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <thread>
+
+#include "FrameRing.h"
+
+/**
+ * A frame grabbed from a camera.
+ */
+struct CapturedFrame
+{
+    cv::Mat image;
+    // Number of the frame since acquisition started, gaps mark frames that
+    // were dropped because the consumer fell behind
+    std::uint64_t sequence;
+    // Taken right after the driver handed out the frame
+    std::chrono::steady_clock::time_point captured;
+};
+
+/**
+ * Grabs frames of a cv::VideoCapture continuously on a dedicated thread into
+ * a ring, so that the device is drained at the sensor rate no matter how long
+ * tracking or rendering of a frame takes.
+ *
+ * The acquisition never waits for the consumer: if the ring is full the
+ * oldest frame is dropped, which shows as a gap in the sequence numbers.
+ * While running, the acquisition owns the capture, the caller must stop() it
+ * before changing properties of the capture.
+ */
+class CameraAcquisition
+{
+public:
+    explicit CameraAcquisition(std::size_t depth);
+    ~CameraAcquisition();
+
+    CameraAcquisition(const CameraAcquisition&) = delete;
+    CameraAcquisition& operator=(const CameraAcquisition&) = delete;
+
+    void start(cv::VideoCapture* capture);
+
+    /**
+     * Stops the acquisition thread and discards all queued frames. Sequence
+     * numbers continue when restarted.
+     */
+    void stop();
+
+    bool running() const;
+
+    /**
+     * @return the oldest queued frame, waits if none was captured yet.
+     * std::nullopt signals that the device stopped delivering frames.
+     */
+    std::optional<CapturedFrame> pop();
+
+    /**
+     * @return the time acquisition was first started, the reference of
+     * timestamps relative to the stream.
+     */
+    std::chrono::steady_clock::time_point started() const
+    {
+        return _started;
+    }
+
+    /**
+     * Number of frames dropped because the ring was full.
+     */
+    std::uint64_t dropped() const
+    {
+        return _dropped;
+    }
+
+private:
+    void run();
+
+    FrameRing<CapturedFrame>              _ring;
+    std::thread                           _thread;
+    std::atomic<bool>                     _abort;
+    cv::VideoCapture*                     _capture;
+    std::uint64_t                         _sequence;
+    std::atomic<std::uint64_t>            _dropped;
+    std::chrono::steady_clock::time_point _started;
+};
@@ -0,0 +1,220 @@
+#include "CameraProbe.h"
+
+#include <QCameraInfo>
+#include <QDebug>
+#if HAS_PYLON
+    #include "camera/pylon.h"
+#endif
+
+#include <algorithm>
+#include <future>
+
+namespace
+{
+    // Common resolutions offered to the cameras while probing
+    const cv::Size Resolutions[] = {{320, 240},
+                                    {640, 480},
+                                    {800, 600},
+                                    {1024, 768},
+                                    {1280, 720},
+                                    {1280, 1024},
+                                    {1920, 1080},
+                                    {2560, 1440},
+                                    {3840, 2160}};
+
+    bool sameDevice(const CameraSelector& a, const CameraSelector& b)
+    {
+        return a.type == b.type && a.index == b.index && a.name == b.name;
+    }
+}
+
+CameraProbe& CameraProbe::instance()
+{
+    static CameraProbe probe;
+    return probe;
+}
+
+CameraProbe::~CameraProbe()
+{
+    if (_worker.joinable()) {
+        _worker.join();
+    }
+}
+
+void CameraProbe::setTimeout(std::chrono::milliseconds timeout)
+{
+    _timeout = timeout.count();
+}
+
+std::chrono::milliseconds CameraProbe::timeout() const
+{
+    return std::chrono::milliseconds(_timeout.load());
+}
+
+void CameraProbe::refresh()
+{
+    if (_probing.exchange(true)) {
+        return;
+    }
+    if (_worker.joinable()) {
+        _worker.join();
+    }
+
+    // Listing is cheap, the capabilities of known cameras are kept
+    std::vector<Device>      listed;
+    const QList<QCameraInfo> cameras = QCameraInfo::availableCameras();
+    const std::vector<Device> known  = devices();
+    for (int index = 0; index < cameras.size(); ++index) {
+        Device device{
+            cameras[index].description(),
+            CameraSelector{CameraType::OpenCV,
+                           index,
+                           cameras[index].deviceName().toStdString()},
+            {}};
+        for (const Device& other : known) {
+            if (sameDevice(other.selector, device.selector)) {
+                device.modes = other.modes;
+            }
+        }
+        listed.push_back(device);
+    }
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _devices = listed;
+    }
+    Q_EMIT devicesProbed();
+
+    _worker = std::thread(
+        [this, listed]() mutable { probe(std::move(listed)); });
+}
+
+std::vector<CameraProbe::Device> CameraProbe::devices() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _devices;
+}
+
+void CameraProbe::probe(std::vector<Device> listed)
+{
+    for (Device& device : listed) {
+        if (!device.modes.empty()) {
+            continue;
+        }
+        // Fails while the camera is in use, it is probed again next time
+        if (auto capture = open(device.selector, timeout())) {
+            device.modes = probeModes(*capture);
+        }
+    }
+
+    // Usually there is no XIMEA camera, so it is tried once
+    const CameraSelector ximea{CameraType::OpenCV, cv::CAP_XIAPI, ""};
+    if (auto capture = open(ximea, timeout(), false)) {
+        listed.push_back(Device{"XIMEA default", ximea, probeModes(*capture)});
+    }
+
+#if HAS_PYLON
+    {
+        Pylon::PylonAutoInitTerm pylon;
+
+        auto&                   factory = Pylon::CTlFactory::GetInstance();
+        Pylon::DeviceInfoList_t pylonDevices;
+        factory.EnumerateDevices(pylonDevices);
+
+        for (int index = 0; index < pylonDevices.size(); ++index) {
+            listed.push_back(
+                Device{QString{pylonDevices[index].GetFriendlyName()},
+                       CameraSelector{CameraType::Pylon, index, ""},
+                       {}});
+        }
+    }
+#endif
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _devices = std::move(listed);
+    }
+    _probing = false;
+    Q_EMIT devicesProbed();
+}
+
+std::shared_ptr<cv::VideoCapture> CameraProbe::open(
+    const CameraSelector&     selector,
+    std::chrono::milliseconds timeout,
+    bool                      retry)
+{
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (true) {
+        // An attempt that does not return in time keeps its capture, which
+        // is released when it eventually does
+        auto capture = std::make_shared<cv::VideoCapture>();
+        auto opened  = std::make_shared<std::promise<bool>>();
+        std::future<bool> result = opened->get_future();
+        std::thread([capture, opened, selector] {
+            bool success = !selector.name.empty() &&
+                           capture->open(selector.name);
+            if (!success) {
+                success = capture->open(selector.index);
+            }
+            opened->set_value(success);
+        }).detach();
+
+        if (result.wait_until(deadline) != std::future_status::ready) {
+            qWarning() << "Camera" << selector.index << "did not open within"
+                       << timeout.count() << "ms";
+            return nullptr;
+        }
+        if (result.get()) {
+            return capture;
+        }
+        if (!retry ||
+            std::chrono::steady_clock::now() + RetryInterval >= deadline) {
+            return nullptr;
+        }
+        std::this_thread::sleep_for(RetryInterval);
+    }
+}
+
+bool CameraProbe::waitForFrame(cv::VideoCapture&         capture,
+                               std::chrono::milliseconds timeout)
+{
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!capture.grab()) {
+        if (std::chrono::steady_clock::now() + PollInterval >= deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(PollInterval);
+    }
+    return true;
+}
+
+std::vector<CameraProbe::Mode> CameraProbe::probeModes(
+    cv::VideoCapture& capture)
+{
+    std::vector<Mode> modes;
+    const auto        addCurrent = [&capture, &modes] {
+        const Mode mode{
+            static_cast<int>(capture.get(cv::CAP_PROP_FRAME_WIDTH)),
+            static_cast<int>(capture.get(cv::CAP_PROP_FRAME_HEIGHT)),
+            capture.get(cv::CAP_PROP_FPS)};
+        const bool known = std::any_of(
+            modes.begin(), modes.end(), [&mode](const Mode& other) {
+                return other.width == mode.width &&
+                       other.height == mode.height;
+            });
+        if (mode.width > 0 && mode.height > 0 && !known) {
+            modes.push_back(mode);
+        }
+    };
+
+    // Cameras answer an unsupported resolution with the closest one
+    addCurrent();
+    for (const cv::Size& size : Resolutions) {
+        capture.set(cv::CAP_PROP_FRAME_WIDTH, size.width);
+        capture.set(cv::CAP_PROP_FRAME_HEIGHT, size.height);
+        addCurrent();
+    }
+    std::sort(modes.begin(), modes.end(), [](const Mode& a, const Mode& b) {
+        return a.width * a.height < b.width * b.height;
+    });
+    return modes;
+}
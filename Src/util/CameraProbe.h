@@ -0,0 +1,113 @@
+#pragma once
+
+#include "camera/base.h"
+
+#include <QObject>
+#include <QString>
+#include <opencv2/opencv.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Opens OpenCV cameras without blocking on unresponsive drivers, and keeps
+ * the capabilities of the connected cameras. They are probed on a background
+ * thread, started when the application starts, so that choosing a camera
+ * does not wait for the devices.
+ */
+class CameraProbe : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * A resolution a camera accepted, with the frame rate it reported for it.
+     */
+    struct Mode
+    {
+        int    width;
+        int    height;
+        double fps;
+    };
+
+    struct Device
+    {
+        QString           description;
+        CameraSelector    selector;
+        // Empty while the device has not been probed
+        std::vector<Mode> modes;
+    };
+
+    static CameraProbe& instance();
+
+    ~CameraProbe();
+
+    /**
+     * Timeout of every camera open, also while probing.
+     */
+    void setTimeout(std::chrono::milliseconds timeout);
+
+    std::chrono::milliseconds timeout() const;
+
+    /**
+     * Lists the cameras and probes the capabilities of those not probed
+     * before on the background thread, unless it is probing already. Has to
+     * be called on the GUI thread.
+     */
+    void refresh();
+
+    /**
+     * @return the cameras listed last, with the capabilities probed so far.
+     */
+    std::vector<Device> devices() const;
+
+    /**
+     * Opens the camera of selector, by name if it has one, else by index.
+     * Failed attempts are retried until timeout, unless retry is false.
+     * Every attempt runs on a thread of its own, so a driver that hangs does
+     * not block the caller.
+     * @return the opened capture, or nullptr if the camera could not be
+     * opened in time.
+     */
+    static std::shared_ptr<cv::VideoCapture> open(
+        const CameraSelector&     selector,
+        std::chrono::milliseconds timeout,
+        bool                      retry = true);
+
+    /**
+     * Polls capture until it delivers a frame. Cameras often need a while
+     * after opening before the first one.
+     * @return false if there was none within timeout.
+     */
+    static bool waitForFrame(cv::VideoCapture&         capture,
+                             std::chrono::milliseconds timeout);
+
+Q_SIGNALS:
+    /**
+     * Emitted on the background thread when devices() changed.
+     */
+    void devicesProbed();
+
+private:
+    CameraProbe() = default;
+
+    void probe(std::vector<Device> listed);
+
+    /**
+     * @return the resolutions capture accepts out of common ones.
+     */
+    static std::vector<Mode> probeModes(cv::VideoCapture& capture);
+
+    static constexpr std::chrono::milliseconds RetryInterval{100};
+    static constexpr std::chrono::milliseconds PollInterval{20};
+
+    mutable std::mutex        _mutex;
+    std::vector<Device>       _devices;
+    std::atomic<bool>         _probing{false};
+    std::atomic<long long>    _timeout{5000};
+    std::thread               _worker;
+};
@@ -5,6 +5,7 @@
 #include <QStringList>
 #include <iostream>
 #include <QFile>
+#include <QFileInfo>
 #include <QDir>
 #include <boost/algorithm/string/predicate.hpp>
 #include <boost/lexical_cast.hpp>
@@ -99,6 +100,63 @@ void Config::load(QString dir, QString file)
                                         config->CameraWidth);
     config->CameraHeight       = tree.get<int>(globalPrefix + "CameraHeight",
                                          config->CameraHeight);
+    config->VideoReadAhead = tree.get<int>(globalPrefix + "VideoReadAhead",
+                                           config->VideoReadAhead);
+    config->PicturePrefetch = tree.get<int>(globalPrefix + "PicturePrefetch",
+                                            config->PicturePrefetch);
+    config->PrefetchThreads = tree.get<int>(globalPrefix + "PrefetchThreads",
+                                            config->PrefetchThreads);
+    config->VideoSeekIndex  = tree.get<int>(globalPrefix + "VideoSeekIndex",
+                                           config->VideoSeekIndex);
+    config->FrameCacheMB    = tree.get<int>(globalPrefix + "FrameCacheMB",
+                                         config->FrameCacheMB);
+    config->BatchPreOpen    = tree.get<int>(globalPrefix + "BatchPreOpen",
+                                         config->BatchPreOpen);
+    config->RawCacheMB      = tree.get<int>(globalPrefix + "RawCacheMB",
+                                       config->RawCacheMB);
+    config->RawCacheGrayscale = tree.get<int>(globalPrefix +
+                                                  "RawCacheGrayscale",
+                                              config->RawCacheGrayscale);
+    config->ConcatenateVideos = tree.get<int>(globalPrefix +
+                                                  "ConcatenateVideos",
+                                              config->ConcatenateVideos);
+    config->InputPixelFormat  = tree.get<QString>(globalPrefix +
+                                                     "InputPixelFormat",
+                                                 config->InputPixelFormat);
+    config->FramePoolMB       = tree.get<int>(globalPrefix + "FramePoolMB",
+                                        config->FramePoolMB);
+    config->CameraRing        = tree.get<int>(globalPrefix + "CameraRing",
+                                       config->CameraRing);
+    config->CameraOpenTimeout = tree.get<int>(globalPrefix +
+                                                  "CameraOpenTimeout",
+                                              config->CameraOpenTimeout);
+    config->ProbeCameras      = tree.get<int>(globalPrefix + "ProbeCameras",
+                                         config->ProbeCameras);
+    config->NetworkLatency    = tree.get<int>(globalPrefix + "NetworkLatency",
+                                           config->NetworkLatency);
+    config->NetworkBuffer     = tree.get<int>(globalPrefix + "NetworkBuffer",
+                                          config->NetworkBuffer);
+    config->ReverseSegment    = tree.get<int>(globalPrefix + "ReverseSegment",
+                                           config->ReverseSegment);
+    config->SkimKeyframes     = tree.get<int>(globalPrefix + "SkimKeyframes",
+                                          config->SkimKeyframes);
+    config->SkimSeconds = tree.get<double>(globalPrefix + "SkimSeconds",
+                                           config->SkimSeconds);
+    config->MotionSkip  = tree.get<int>(globalPrefix + "MotionSkip",
+                                       config->MotionSkip);
+    config->MotionThreshold  = tree.get<double>(globalPrefix +
+                                                   "MotionThreshold",
+                                               config->MotionThreshold);
+    config->MotionIdleStride = tree.get<int>(globalPrefix +
+                                                 "MotionIdleStride",
+                                             config->MotionIdleStride);
+    config->MotionPadding    = tree.get<int>(globalPrefix + "MotionPadding",
+                                          config->MotionPadding);
+    config->Background       = tree.get<int>(globalPrefix + "Background",
+                                       config->Background);
+    config->BackgroundSamples = tree.get<int>(globalPrefix +
+                                                  "BackgroundSamples",
+                                              config->BackgroundSamples);
     config->GpuQp = tree.get<double>(globalPrefix + "GpuQp", config->GpuQp);
     config->DefaultLocationManualSave = tree.get<QString>(
         globalPrefix + "DefaultLocationManualSave",
@@ -115,6 +173,10 @@ void Config::load(QString dir, QString file)
                                                config->DirScreenshots);
     config->DirTemp        = tree.get<QString>(globalPrefix + "DirTemp",
                                         config->DirTemp);
+    config->RawCacheDir    = tree.get<QString>(globalPrefix + "RawCacheDir",
+                                            config->RawCacheDir);
+    config->BackgroundDir  = tree.get<QString>(globalPrefix + "BackgroundDir",
+                                              config->BackgroundDir);
     config->AreaDefinitions      = tree.get<QString>(globalPrefix +
                                                     "AreaDefinitions",
                                                 config->AreaDefinitions);
@@ -123,6 +185,14 @@ void Config::load(QString dir, QString file)
                                                  config->UseRegistryLocations);
 }
 
+QString Config::seekIndexDirectory() const
+{
+    if (!VideoSeekIndex) {
+        return "";
+    }
+    return QFileInfo(AreaDefinitions).absolutePath() + "/seekindex";
+}
+
 void Config::save(QString dir, QString file)
 {
     using namespace boost::property_tree;
@@ -146,6 +216,31 @@ void Config::save(QString dir, QString file)
     tree.put(globalPrefix + "RecordFPS", config->RecordFPS);
     tree.put(globalPrefix + "CameraWidth", config->CameraWidth);
     tree.put(globalPrefix + "CameraHeight", config->CameraHeight);
+    tree.put(globalPrefix + "VideoReadAhead", config->VideoReadAhead);
+    tree.put(globalPrefix + "PicturePrefetch", config->PicturePrefetch);
+    tree.put(globalPrefix + "PrefetchThreads", config->PrefetchThreads);
+    tree.put(globalPrefix + "VideoSeekIndex", config->VideoSeekIndex);
+    tree.put(globalPrefix + "FrameCacheMB", config->FrameCacheMB);
+    tree.put(globalPrefix + "BatchPreOpen", config->BatchPreOpen);
+    tree.put(globalPrefix + "RawCacheMB", config->RawCacheMB);
+    tree.put(globalPrefix + "RawCacheGrayscale", config->RawCacheGrayscale);
+    tree.put(globalPrefix + "ConcatenateVideos", config->ConcatenateVideos);
+    tree.put(globalPrefix + "InputPixelFormat", config->InputPixelFormat);
+    tree.put(globalPrefix + "FramePoolMB", config->FramePoolMB);
+    tree.put(globalPrefix + "CameraRing", config->CameraRing);
+    tree.put(globalPrefix + "CameraOpenTimeout", config->CameraOpenTimeout);
+    tree.put(globalPrefix + "ProbeCameras", config->ProbeCameras);
+    tree.put(globalPrefix + "NetworkLatency", config->NetworkLatency);
+    tree.put(globalPrefix + "NetworkBuffer", config->NetworkBuffer);
+    tree.put(globalPrefix + "ReverseSegment", config->ReverseSegment);
+    tree.put(globalPrefix + "SkimKeyframes", config->SkimKeyframes);
+    tree.put(globalPrefix + "SkimSeconds", config->SkimSeconds);
+    tree.put(globalPrefix + "MotionSkip", config->MotionSkip);
+    tree.put(globalPrefix + "MotionThreshold", config->MotionThreshold);
+    tree.put(globalPrefix + "MotionIdleStride", config->MotionIdleStride);
+    tree.put(globalPrefix + "MotionPadding", config->MotionPadding);
+    tree.put(globalPrefix + "Background", config->Background);
+    tree.put(globalPrefix + "BackgroundSamples", config->BackgroundSamples);
     tree.put(globalPrefix + "GpuQp", config->GpuQp);
     tree.put(globalPrefix + "DefaultLocationManualSave",
              config->DefaultLocationManualSave);
@@ -155,6 +250,8 @@ void Config::save(QString dir, QString file)
     tree.put(globalPrefix + "DirTrials", config->DirTrials);
     tree.put(globalPrefix + "DirScreenshots", config->DirScreenshots);
     tree.put(globalPrefix + "DirTemp", config->DirTemp);
+    tree.put(globalPrefix + "RawCacheDir", config->RawCacheDir);
+    tree.put(globalPrefix + "BackgroundDir", config->BackgroundDir);
     tree.put(globalPrefix + "AreaDefinitions", config->AreaDefinitions);
     tree.put(globalPrefix + "UseRegistryLocations",
              config->UseRegistryLocations);
@@ -21,6 +21,31 @@ public:
     int     RecordFPS                 = -1;
     int     CameraWidth               = -1;
     int     CameraHeight              = -1;
+    int     VideoReadAhead            = 0;
+    int     PicturePrefetch           = 0;
+    int     PrefetchThreads           = 0;
+    int     VideoSeekIndex            = 1;
+    int     FrameCacheMB              = 0;
+    int     BatchPreOpen              = 1;
+    int     RawCacheMB                = 0;
+    int     RawCacheGrayscale         = 0;
+    int     ConcatenateVideos         = 0;
+    QString InputPixelFormat          = "BGR";
+    int     FramePoolMB               = 0;
+    int     CameraRing                = 16;
+    int     CameraOpenTimeout         = 5000;
+    int     ProbeCameras              = 1;
+    int     NetworkLatency            = 200;
+    int     NetworkBuffer             = 32;
+    int     ReverseSegment            = 64;
+    int     SkimKeyframes             = 0;
+    double  SkimSeconds               = 0;
+    int     MotionSkip                = 0;
+    double  MotionThreshold           = 1.0;
+    int     MotionIdleStride          = 0;
+    int     MotionPadding             = 30;
+    int     Background                = 0;
+    int     BackgroundSamples         = 100;
     double  GpuQp                     = 20;
     int     UseRegistryLocations      = true;
     QString DefaultLocationManualSave = "";
@@ -30,15 +55,24 @@ public:
     QString DirTrials       = IConfig::dataLocation + "/Tracks/Trials/";
     QString DirScreenshots  = IConfig::dataLocation + "/Screenshots/";
     QString DirTemp         = IConfig::dataLocation + "/temp/";
+    QString RawCacheDir     = IConfig::dataLocation + "/RawCache/";
+    QString BackgroundDir   = IConfig::dataLocation + "/Background/";
     QString AreaDefinitions = IConfig::configLocation + "/areas.csv";
 
     // Temporary CLI configuration
     QString LoadVideo         = "";
+    QString LoadSource        = "";
     QString UsePlugins        = "";
     QString CfgCustomLocation = "";
 
     void load(QString dir, QString file = "config.ini") override;
     void save(QString dir, QString file) override;
 
+    /**
+     * @return where the seek indices of videos are stored, next to the area
+     * definitions, or an empty string if VideoSeekIndex is off.
+     */
+    QString seekIndexDirectory() const;
+
     static const QString DefaultArena;
 };
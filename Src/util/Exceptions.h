@@ -27,6 +27,11 @@ namespace BioTracker
             using std::invalid_argument::invalid_argument;
         };
 
+        struct source_open_error : std::invalid_argument
+        {
+            using std::invalid_argument::invalid_argument;
+        };
+
         struct invalid_tracker_lib_error : std::invalid_argument
         {
             using std::invalid_argument::invalid_argument;
@@ -0,0 +1,199 @@
+#include "FolderWatcher.h"
+
+#include <map>
+
+#ifdef __linux__
+    #include <poll.h>
+    #include <sys/inotify.h>
+    #include <unistd.h>
+#endif
+
+namespace
+{
+    // How long the thread waits for file events before checking for abort
+    const int WaitMs = 50;
+
+    // Writers often create temporary dot files and rename them when done
+    bool hidden(const boost::filesystem::path& file)
+    {
+        const std::string name = file.filename().string();
+        return name.empty() || name[0] == '.';
+    }
+}
+
+FolderWatcher::FolderWatcher(boost::filesystem::path directory,
+                             std::size_t             depth)
+: _directory(std::move(directory))
+, _ring(depth)
+, _abort(false)
+, _flags(cv::IMREAD_COLOR)
+, _dropped(0)
+, _notify(-1)
+{
+}
+
+FolderWatcher::~FolderWatcher()
+{
+    stop();
+}
+
+bool FolderWatcher::start()
+{
+    stop();
+
+    boost::system::error_code error;
+    if (!boost::filesystem::is_directory(_directory, error)) {
+        return false;
+    }
+
+#ifdef __linux__
+    _notify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (_notify < 0) {
+        return false;
+    }
+    if (inotify_add_watch(_notify,
+                          _directory.string().c_str(),
+                          IN_CREATE | IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+        close(_notify);
+        _notify = -1;
+        return false;
+    }
+#else
+    _known.clear();
+    for (const auto& entry :
+         boost::filesystem::directory_iterator(_directory, error)) {
+        _known.insert(entry.path());
+    }
+#endif
+
+    _abort = false;
+    _ring.reset();
+    _thread = std::thread(&FolderWatcher::run, this);
+    return true;
+}
+
+void FolderWatcher::stop()
+{
+    _abort = true;
+    _ring.abort();
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+    _ring.reset();
+#ifdef __linux__
+    if (_notify >= 0) {
+        close(_notify);
+        _notify = -1;
+    }
+#endif
+}
+
+std::optional<WatchedImage> FolderWatcher::popFor(
+    std::chrono::milliseconds timeout)
+{
+    return _ring.popFor(timeout);
+}
+
+void FolderWatcher::run()
+{
+    using Clock = std::chrono::steady_clock;
+
+#ifdef __linux__
+    // Creation times of files still being written
+    std::map<std::string, Clock::time_point> created;
+    alignas(inotify_event) char buffer[16 * 1024];
+
+    while (!_abort) {
+        pollfd ready{_notify, POLLIN, 0};
+        if (poll(&ready, 1, WaitMs) <= 0) {
+            continue;
+        }
+        const auto    now   = Clock::now();
+        const ssize_t bytes = read(_notify, buffer, sizeof(buffer));
+        if (bytes <= 0) {
+            continue;
+        }
+
+        for (ssize_t offset = 0; offset < bytes;) {
+            const auto* event = reinterpret_cast<const inotify_event*>(
+                buffer + offset);
+            offset += sizeof(inotify_event) + event->len;
+            if (event->len == 0 || (event->mask & IN_ISDIR)) {
+                continue;
+            }
+
+            const std::string name(event->name);
+            if (event->mask & IN_CREATE) {
+                created[name] = now;
+            }
+            if (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO)) {
+                auto found = created.find(name);
+                if (found != created.end()) {
+                    deliver(_directory / name, found->second);
+                    created.erase(found);
+                } else {
+                    deliver(_directory / name, now);
+                }
+            }
+        }
+    }
+#else
+    struct Pending
+    {
+        boost::uintmax_t  size;
+        Clock::time_point created;
+    };
+    std::map<boost::filesystem::path, Pending> pending;
+
+    while (!_abort) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(WaitMs));
+        const auto now = Clock::now();
+
+        boost::system::error_code error;
+        for (const auto& entry :
+             boost::filesystem::directory_iterator(_directory, error)) {
+            const auto& file = entry.path();
+            if (_known.count(file) ||
+                !boost::filesystem::is_regular_file(file, error)) {
+                continue;
+            }
+            const boost::uintmax_t size = boost::filesystem::file_size(file,
+                                                                       error);
+            if (error) {
+                continue;
+            }
+
+            auto found = pending.find(file);
+            if (found == pending.end()) {
+                pending[file] = Pending{size, now};
+            } else if (found->second.size != size || size == 0) {
+                found->second.size = size;
+            } else {
+                // Unchanged for an interval, the writer is done
+                _known.insert(file);
+                deliver(file, found->second.created);
+                pending.erase(found);
+            }
+        }
+    }
+#endif
+}
+
+void FolderWatcher::deliver(const boost::filesystem::path&       file,
+                            std::chrono::steady_clock::time_point created)
+{
+    if (hidden(file)) {
+        return;
+    }
+
+    WatchedImage image;
+    image.image = cv::imread(file.string(), _flags);
+    if (image.image.empty()) {
+        return;
+    }
+    image.path    = file;
+    image.created = created;
+    if (_ring.pushOverwrite(std::move(image))) {
+        _dropped++;
+    }
+}
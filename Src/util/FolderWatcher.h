@@ -0,0 +1,86 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <boost/filesystem.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <set>
+#include <thread>
+
+#include "FrameRing.h"
+
+/**
+ * An image picked up by a FolderWatcher.
+ */
+struct WatchedImage
+{
+    cv::Mat                 image;
+    boost::filesystem::path path;
+    // When the file first showed up in the folder
+    std::chrono::steady_clock::time_point created;
+};
+
+/**
+ * Picks up image files as they are written into a folder, e.g. one per
+ * trigger of a camera, and decodes them on a dedicated thread into a ring.
+ *
+ * A file is taken once it is completely written: on Linux when inotify
+ * reports it closed after writing or moved into the folder, elsewhere when
+ * its size stays the same for one polling interval. Files that are not
+ * images are skipped. Like a camera, the watcher never waits for the
+ * consumer, if the ring is full the oldest image is dropped.
+ */
+class FolderWatcher
+{
+public:
+    FolderWatcher(boost::filesystem::path directory, std::size_t depth);
+    ~FolderWatcher();
+
+    FolderWatcher(const FolderWatcher&) = delete;
+    FolderWatcher& operator=(const FolderWatcher&) = delete;
+
+    /**
+     * Starts watching, files already in the folder are ignored.
+     * @return false if the folder cannot be watched
+     */
+    bool start();
+    void stop();
+
+    /**
+     * @return the oldest decoded image, std::nullopt if none arrived within
+     * timeout or watching failed.
+     */
+    std::optional<WatchedImage> popFor(std::chrono::milliseconds timeout);
+
+    void setImreadFlags(int flags)
+    {
+        _flags = flags;
+    }
+
+    /**
+     * Number of images dropped because the ring was full.
+     */
+    std::uint64_t dropped() const
+    {
+        return _dropped;
+    }
+
+private:
+    void run();
+    void deliver(const boost::filesystem::path&       file,
+                 std::chrono::steady_clock::time_point created);
+
+    boost::filesystem::path    _directory;
+    FrameRing<WatchedImage>    _ring;
+    std::thread                _thread;
+    std::atomic<bool>          _abort;
+    std::atomic<int>           _flags;
+    std::atomic<std::uint64_t> _dropped;
+    // inotify descriptor on Linux
+    int _notify;
+    // Files taken or already present at start, when polling the folder
+    std::set<boost::filesystem::path> _known;
+};
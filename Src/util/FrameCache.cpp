@@ -0,0 +1,60 @@
+#include "FrameCache.h"
+
+FrameCache::FrameCache(std::size_t budgetBytes)
+: _budget(budgetBytes)
+{
+}
+
+bool FrameCache::get(std::size_t frame, cv::Mat& image)
+{
+    auto entry = _entries.find(frame);
+    if (entry == _entries.end()) {
+        _misses++;
+        return false;
+    }
+
+    _hits++;
+    _lru.splice(_lru.begin(), _lru, entry->second);
+    image = entry->second->second;
+    return true;
+}
+
+void FrameCache::put(std::size_t frame, const cv::Mat& image)
+{
+    auto existing = _entries.find(frame);
+    if (existing != _entries.end()) {
+        remove(existing->second);
+    }
+
+    const std::size_t bytes = bytesOf(image);
+    if (image.empty() || bytes > _budget) {
+        return;
+    }
+
+    while (_bytes + bytes > _budget) {
+        remove(std::prev(_lru.end()));
+    }
+
+    _lru.emplace_front(frame, image);
+    _entries[frame] = _lru.begin();
+    _bytes += bytes;
+}
+
+void FrameCache::clear()
+{
+    _lru.clear();
+    _entries.clear();
+    _bytes = 0;
+}
+
+std::size_t FrameCache::bytesOf(const cv::Mat& image)
+{
+    return image.total() * image.elemSize();
+}
+
+void FrameCache::remove(std::list<Entry>::iterator entry)
+{
+    _bytes -= bytesOf(entry->second);
+    _entries.erase(entry->first);
+    _lru.erase(entry);
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+/**
+ * Memory bounded least recently used cache of decoded frames, keyed by frame
+ * number.
+ *
+ * Frames are shared with the caller, not copied: decoders hand out a new
+ * buffer for every frame. Tracking plugins, which may draw into their input,
+ * get a copy while the cache is enabled.
+ */
+class FrameCache
+{
+public:
+    explicit FrameCache(std::size_t budgetBytes);
+
+    /**
+     * Looks up frame and counts a hit or a miss.
+     * @return true if the frame was cached.
+     */
+    bool get(std::size_t frame, cv::Mat& image);
+
+    /**
+     * Inserts or refreshes frame, evicting the least recently used frames
+     * until the cache fits its budget again.
+     */
+    void put(std::size_t frame, const cv::Mat& image);
+
+    void clear();
+
+    std::size_t hits() const
+    {
+        return _hits;
+    }
+
+    std::size_t misses() const
+    {
+        return _misses;
+    }
+
+    std::size_t bytes() const
+    {
+        return _bytes;
+    }
+
+    std::size_t size() const
+    {
+        return _lru.size();
+    }
+
+private:
+    using Entry = std::pair<std::size_t, cv::Mat>;
+
+    static std::size_t bytesOf(const cv::Mat& image);
+
+    void remove(std::list<Entry>::iterator entry);
+
+    // Most recently used first
+    std::list<Entry>                                             _lru;
+    std::unordered_map<std::size_t, std::list<Entry>::iterator> _entries;
+    std::size_t                                                  _budget;
+    std::size_t                                                  _bytes  = 0;
+    std::size_t                                                  _hits   = 0;
+    std::size_t                                                  _misses = 0;
+};
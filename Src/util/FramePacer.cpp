@@ -0,0 +1,17 @@
+#include "FramePacer.h"
+
+#include <thread>
+
+void FramePacer::wait()
+{
+    if (_targetFps > 0) {
+        const auto interval = std::chrono::duration_cast<
+            std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(1. / _targetFps));
+        const auto elapsed = std::chrono::steady_clock::now() - _last;
+        if (elapsed < interval) {
+            std::this_thread::sleep_for(interval - elapsed);
+        }
+    }
+    _last = std::chrono::steady_clock::now();
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <chrono>
+
+/**
+ * Limits playback to a frame rate: wait() sleeps for what is left of the
+ * frame interval since the previous call.
+ */
+class FramePacer
+{
+public:
+    /**
+     * @param fps the target frame rate, 0 for no limit
+     */
+    void setFps(double fps)
+    {
+        _targetFps = fps;
+    }
+
+    void wait();
+
+private:
+    std::chrono::steady_clock::time_point _last;
+    double                                _targetFps = 0;
+};
@@ -0,0 +1,173 @@
+#include "FramePool.h"
+
+namespace
+{
+    std::atomic<FramePool*> sharedPool{nullptr};
+}
+
+FramePool::FramePool(std::size_t budgetBytes)
+: _budget(budgetBytes)
+{
+}
+
+FramePool::~FramePool()
+{
+    for (auto& sizeClass : _classes) {
+        for (void* block : sizeClass.second.blocks) {
+            cv::fastFree(block);
+        }
+    }
+}
+
+FramePool* FramePool::shared(std::size_t budgetBytes)
+{
+    static FramePool* pool = new FramePool(budgetBytes);
+    sharedPool             = pool;
+    return pool;
+}
+
+FramePool* FramePool::instance()
+{
+    return sharedPool;
+}
+
+cv::UMatData* FramePool::allocate(int                dims,
+                                  const int*         sizes,
+                                  int                type,
+                                  void*              data,
+                                  size_t*            step,
+                                  AccessFlag,
+                                  cv::UMatUsageFlags) const
+{
+    // Same layout as OpenCV's standard allocator
+    std::size_t total = CV_ELEM_SIZE(type);
+    for (int i = dims - 1; i >= 0; i--) {
+        if (step) {
+            if (data && step[i] != CV_AUTOSTEP) {
+                CV_Assert(total <= step[i]);
+                total = step[i];
+            } else {
+                step[i] = total;
+            }
+        }
+        total *= sizes[i];
+    }
+
+    cv::UMatData* u = new cv::UMatData(this);
+    u->size         = total;
+    if (data) {
+        u->data = u->origdata = static_cast<uchar*>(data);
+        u->flags |= cv::UMatData::USER_ALLOCATED;
+    } else {
+        u->data = u->origdata = static_cast<uchar*>(take(total));
+    }
+    return u;
+}
+
+bool FramePool::allocate(cv::UMatData* data,
+                         AccessFlag,
+                         cv::UMatUsageFlags) const
+{
+    return data != nullptr;
+}
+
+void FramePool::deallocate(cv::UMatData* u) const
+{
+    if (!u) {
+        return;
+    }
+    CV_Assert(u->urefcount == 0);
+    CV_Assert(u->refcount == 0);
+    if (!(u->flags & cv::UMatData::USER_ALLOCATED)) {
+        give(u->origdata, u->size);
+        u->origdata = nullptr;
+    }
+    delete u;
+}
+
+std::size_t FramePool::pooledBytes() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _pooled;
+}
+
+std::size_t FramePool::classSize(std::size_t bytes)
+{
+    std::size_t octave = MinPooledBytes;
+    while (octave * 2 <= bytes) {
+        octave *= 2;
+    }
+    const std::size_t step = octave / 4;
+    return (bytes + step - 1) / step * step;
+}
+
+void* FramePool::take(std::size_t bytes) const
+{
+    if (bytes < MinPooledBytes) {
+        return cv::fastMalloc(bytes);
+    }
+
+    const std::size_t size = classSize(bytes);
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        SizeClass&                  sizeClass = _classes[size];
+        sizeClass.lastUse                     = ++_clock;
+        if (!sizeClass.blocks.empty()) {
+            void* block = sizeClass.blocks.back();
+            sizeClass.blocks.pop_back();
+            _pooled -= size;
+            _hits++;
+            return block;
+        }
+    }
+    _misses++;
+    return cv::fastMalloc(size);
+}
+
+void FramePool::give(void* block, std::size_t bytes) const
+{
+    if (bytes < MinPooledBytes) {
+        cv::fastFree(block);
+        return;
+    }
+
+    const std::size_t  size = classSize(bytes);
+    std::vector<void*> released;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        SizeClass&                  current = _classes[size];
+
+        // Make room by releasing the buffers of classes which have not been
+        // asked for the longest, e.g. those of a previous video
+        while (_pooled + size > _budget) {
+            auto oldest = _classes.end();
+            for (auto it = _classes.begin(); it != _classes.end(); ++it) {
+                if (&it->second != &current && !it->second.blocks.empty() &&
+                    (oldest == _classes.end() ||
+                     it->second.lastUse < oldest->second.lastUse)) {
+                    oldest = it;
+                }
+            }
+            if (oldest == _classes.end()) {
+                break;
+            }
+            released.push_back(oldest->second.blocks.back());
+            oldest->second.blocks.pop_back();
+            _pooled -= oldest->first;
+        }
+
+        if (_pooled + size <= _budget) {
+            current.blocks.push_back(block);
+            _pooled += size;
+            block = nullptr;
+        }
+    }
+
+    // Freeing outside of the lock, unmapping large buffers takes a while
+    for (void* old : released) {
+        cv::fastFree(old);
+    }
+    if (block) {
+        cv::fastFree(block);
+    }
+}
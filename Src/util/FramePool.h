@@ -0,0 +1,109 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <vector>
+
+/**
+ * Allocator for cv::Mat which keeps the buffers of released frames and hands
+ * them out again, so that decoding, display and recording at high frame rates
+ * and resolutions do not allocate and fault in fresh pages for every frame.
+ *
+ * It is not the default allocator: streams opt in by setting it as the
+ * allocator of the buffers they decode into, and display and recording use
+ * instance() for their per-frame buffers. Other copies made from such
+ * frames use the default allocation.
+ *
+ * Requests are rounded up to size classes spaced a quarter octave apart,
+ * which wastes at most a fifth of a buffer. Small requests are passed on to
+ * the default allocation, as the system allocator handles them well. Freed
+ * buffers are kept up to a byte budget, beyond which the buffers of the least
+ * recently used size class are released.
+ */
+class FramePool : public cv::MatAllocator
+{
+public:
+#if CV_VERSION_MAJOR >= 4
+    using AccessFlag = cv::AccessFlag;
+#else
+    using AccessFlag = int;
+#endif
+
+    /**
+     * Requests below this size are not pooled.
+     */
+    static const std::size_t MinPooledBytes = 64 * 1024;
+
+    explicit FramePool(std::size_t budgetBytes);
+    ~FramePool() override;
+
+    /**
+     * @return the pool shared by all streams, created with budgetBytes on
+     * the first call. It lives until the process exits, as frames allocated
+     * from it may be released at any time.
+     */
+    static FramePool* shared(std::size_t budgetBytes);
+
+    /**
+     * @return the shared pool, or nullptr if no stream asked for it yet.
+     */
+    static FramePool* instance();
+
+    cv::UMatData* allocate(int                dims,
+                           const int*         sizes,
+                           int                type,
+                           void*              data,
+                           size_t*            step,
+                           AccessFlag         flags,
+                           cv::UMatUsageFlags usageFlags) const override;
+    bool          allocate(cv::UMatData*      data,
+                           AccessFlag         accessFlags,
+                           cv::UMatUsageFlags usageFlags) const override;
+    void          deallocate(cv::UMatData* data) const override;
+
+    /**
+     * Number of pooled requests served from a released buffer.
+     */
+    std::size_t hits() const
+    {
+        return _hits;
+    }
+
+    /**
+     * Number of pooled requests which needed a new buffer.
+     */
+    std::size_t misses() const
+    {
+        return _misses;
+    }
+
+    /**
+     * Bytes held in released buffers.
+     */
+    std::size_t pooledBytes() const;
+
+private:
+    struct SizeClass
+    {
+        std::vector<void*> blocks;
+        std::uint64_t      lastUse = 0;
+    };
+
+    static std::size_t classSize(std::size_t bytes);
+
+    void* take(std::size_t bytes) const;
+    void  give(void* block, std::size_t bytes) const;
+
+    std::size_t _budget;
+
+    mutable std::mutex                       _mutex;
+    mutable std::map<std::size_t, SizeClass> _classes;
+    mutable std::size_t                      _pooled = 0;
+    mutable std::uint64_t                    _clock  = 0;
+    mutable std::atomic<std::size_t>         _hits{0};
+    mutable std::atomic<std::size_t>         _misses{0};
+};
@@ -0,0 +1,182 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <optional>
+
+/**
+ * Bounded FIFO which hands items (usually decoded frames) from a producer
+ * thread to a consumer thread.
+ *
+ * push() blocks while the ring is full, pop() blocks while it is empty.
+ * close() marks the end of the stream: pending items can still be popped,
+ * afterwards pop() returns std::nullopt. abort() drops all items and wakes up
+ * every waiting thread; it is used to cancel a producer, e.g. on a seek.
+ */
+template<typename T>
+class FrameRing
+{
+public:
+    explicit FrameRing(std::size_t capacity = 1)
+    : _capacity(capacity > 0 ? capacity : 1)
+    {
+    }
+
+    void setCapacity(std::size_t capacity)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _capacity = capacity > 0 ? capacity : 1;
+        _notFull.notify_all();
+    }
+
+    std::size_t capacity() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _capacity;
+    }
+
+    /**
+     * Appends an item, waits for free space if the ring is full.
+     * @return false if the ring was aborted or closed while waiting.
+     */
+    bool push(T item)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _notFull.wait(lock, [this] {
+            return _items.size() < _capacity || _aborted || _closed;
+        });
+        if (_aborted || _closed) {
+            return false;
+        }
+        _items.push_back(std::move(item));
+        _notEmpty.notify_one();
+        return true;
+    }
+
+    /**
+     * Appends an item without ever blocking. If the ring is full the oldest
+     * item is dropped.
+     * @return true if an item had to be dropped.
+     */
+    bool pushOverwrite(T item)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_aborted || _closed) {
+            return false;
+        }
+        bool dropped = false;
+        while (_items.size() >= _capacity) {
+            _items.pop_front();
+            dropped = true;
+        }
+        _items.push_back(std::move(item));
+        _notEmpty.notify_one();
+        return dropped;
+    }
+
+    /**
+     * Takes the oldest item, waits if the ring is empty.
+     * @return std::nullopt if the ring was aborted, or closed and drained.
+     */
+    std::optional<T> pop()
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _notEmpty.wait(lock, [this] {
+            return !_items.empty() || _aborted || _closed;
+        });
+        return takeFront();
+    }
+
+    /**
+     * Like pop(), but gives up after the timeout.
+     */
+    template<typename Rep, typename Period>
+    std::optional<T> popFor(const std::chrono::duration<Rep, Period>& timeout)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _notEmpty.wait_for(lock, timeout, [this] {
+            return !_items.empty() || _aborted || _closed;
+        });
+        return takeFront();
+    }
+
+    /**
+     * Takes the oldest item if there is one, never blocks.
+     */
+    std::optional<T> tryPop()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return takeFront();
+    }
+
+    /**
+     * Marks the end of the stream. Already queued items stay available.
+     */
+    void close()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _closed = true;
+        _notEmpty.notify_all();
+        _notFull.notify_all();
+    }
+
+    /**
+     * Drops all items and wakes up every waiting producer and consumer.
+     */
+    void abort()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _aborted = true;
+        _items.clear();
+        _notEmpty.notify_all();
+        _notFull.notify_all();
+    }
+
+    /**
+     * Drops all items and makes the ring usable again after abort() or
+     * close().
+     */
+    void reset()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _items.clear();
+        _aborted = false;
+        _closed  = false;
+        _notFull.notify_all();
+    }
+
+    bool closed() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _closed;
+    }
+
+    std::size_t size() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _items.size();
+    }
+
+private:
+    std::optional<T> takeFront()
+    {
+        if (_aborted || _items.empty()) {
+            return std::nullopt;
+        }
+        std::optional<T> item(std::move(_items.front()));
+        _items.pop_front();
+        _notFull.notify_one();
+        return item;
+    }
+
+    mutable std::mutex      _mutex;
+    std::condition_variable _notEmpty;
+    std::condition_variable _notFull;
+    std::deque<T>           _items;
+    std::size_t             _capacity;
+    bool                    _closed  = false;
+    bool                    _aborted = false;
+};
@@ -0,0 +1,122 @@
+#include "FrameTimestamps.h"
+
+#include <cmath>
+#include <iterator>
+
+constexpr std::size_t FrameTimestamps::MaxRunLength;
+constexpr std::size_t FrameTimestamps::MaxFrameGap;
+
+namespace
+{
+    void putVarint(std::vector<std::uint8_t>& data, std::uint64_t value)
+    {
+        while (value >= 0x80) {
+            data.push_back(static_cast<std::uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        data.push_back(static_cast<std::uint8_t>(value));
+    }
+
+    std::uint64_t getVarint(const std::vector<std::uint8_t>& data,
+                            std::size_t&                     offset)
+    {
+        std::uint64_t value = 0;
+        for (int shift = 0; offset < data.size(); shift += 7) {
+            const std::uint8_t byte = data[offset++];
+            value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) {
+                break;
+            }
+        }
+        return value;
+    }
+
+    // Maps signed deltas to small unsigned values: 0, -1, 1, -2, ...
+    std::uint64_t zigzag(std::int64_t value)
+    {
+        return (static_cast<std::uint64_t>(value) << 1) ^
+               static_cast<std::uint64_t>(value >> 63);
+    }
+
+    std::int64_t unzigzag(std::uint64_t value)
+    {
+        return static_cast<std::int64_t>(value >> 1) ^
+               -static_cast<std::int64_t>(value & 1);
+    }
+}
+
+void FrameTimestamps::record(std::size_t frame, double ms)
+{
+    const auto us = static_cast<std::int64_t>(std::llround(ms * 1000));
+
+    auto run = _runs.upper_bound(frame);
+    if (run != _runs.begin()) {
+        --run;
+        if (frame <= run->second.last) {
+            return;
+        }
+        auto next = std::next(run);
+        if (run->second.count < MaxRunLength &&
+            frame - run->second.last <= MaxFrameGap &&
+            (next == _runs.end() || frame < next->first)) {
+            Run&               r     = run->second;
+            const std::int64_t delta = us - r.lastUs;
+            putVarint(r.data, frame - r.last);
+            putVarint(r.data, zigzag(delta - r.lastDeltaUs));
+            r.last        = frame;
+            r.lastUs      = us;
+            r.lastDeltaUs = delta;
+            r.count++;
+            return;
+        }
+    }
+
+    Run r;
+    r.last        = frame;
+    r.firstUs     = us;
+    r.lastUs      = us;
+    r.lastDeltaUs = 0;
+    r.count       = 1;
+    _runs.emplace(frame, std::move(r));
+}
+
+std::optional<double> FrameTimestamps::at(std::size_t frame) const
+{
+    auto run = _runs.upper_bound(frame);
+    if (run == _runs.begin()) {
+        return std::nullopt;
+    }
+    --run;
+    const Run& r = run->second;
+    if (frame > r.last) {
+        return std::nullopt;
+    }
+
+    std::size_t  current = run->first;
+    std::int64_t us      = r.firstUs;
+    std::int64_t delta   = 0;
+    std::size_t  offset  = 0;
+    while (current < frame && offset < r.data.size()) {
+        current += getVarint(r.data, offset);
+        delta += unzigzag(getVarint(r.data, offset));
+        us += delta;
+    }
+    if (current != frame) {
+        return std::nullopt;
+    }
+    return us / 1000.0;
+}
+
+void FrameTimestamps::clear()
+{
+    _runs.clear();
+}
+
+std::size_t FrameTimestamps::encodedBytes() const
+{
+    std::size_t bytes = 0;
+    for (const auto& run : _runs) {
+        bytes += sizeof(Run) + run.second.data.size();
+    }
+    return bytes;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <vector>
+
+/**
+ * Timestamps of frames, recorded in playback order and looked up by frame
+ * number, e.g. for the exporters.
+ *
+ * Frames are stored in runs of increasing frame numbers. Within a run the
+ * frame number deltas and the second order deltas of the timestamps (in
+ * microseconds) are varint encoded: at a steady frame rate a frame takes
+ * about two bytes instead of sixteen for a plain (frame, time) pair.
+ */
+class FrameTimestamps
+{
+public:
+    /**
+     * Records the timestamp of frame in milliseconds. Frames within the
+     * range of a recorded run, e.g. after seeking back, are ignored.
+     */
+    void record(std::size_t frame, double ms);
+
+    /**
+     * @return the timestamp of frame in milliseconds, std::nullopt if it
+     * was not recorded.
+     */
+    std::optional<double> at(std::size_t frame) const;
+
+    void clear();
+
+    /**
+     * Number of bytes used by the encoded timestamps.
+     */
+    std::size_t encodedBytes() const;
+
+private:
+    struct Run
+    {
+        std::size_t               last;
+        std::int64_t              firstUs;
+        std::int64_t              lastUs;
+        std::int64_t              lastDeltaUs;
+        std::size_t               count;
+        std::vector<std::uint8_t> data;
+    };
+
+    // Bounds the decoding work of a lookup
+    static constexpr std::size_t MaxRunLength = 256;
+    // A larger jump, e.g. a seek, starts a new run, so that the frames
+    // skipped can still be recorded later
+    static constexpr std::size_t MaxFrameGap = 64;
+
+    // Keyed by the first frame of the run
+    std::map<std::size_t, Run> _runs;
+};
@@ -0,0 +1,91 @@
+#include "ImagePrefetcher.h"
+
+ImagePrefetcher::ImagePrefetcher(
+    const std::vector<boost::filesystem::path>& files,
+    std::size_t                                 depth,
+    std::size_t                                 threads)
+: _files(files)
+, _depth(depth)
+, _flags(cv::IMREAD_COLOR)
+, _pool(threads)
+{
+}
+
+ImagePrefetcher::~ImagePrefetcher()
+{
+    cancel();
+}
+
+cv::Mat ImagePrefetcher::get(std::size_t index, std::size_t stride)
+{
+    if (index >= _files.size()) {
+        return cv::Mat();
+    }
+    stride = stride > 0 ? stride : 1;
+
+    // Drop everything that is not part of the new window
+    const std::size_t last = index + _depth * stride;
+    for (auto it = _pending.begin(); it != _pending.end();) {
+        const std::size_t i = it->first;
+        if (i < index || i > last || (i - index) % stride != 0) {
+            *it->second.cancelled = true;
+            it                    = _pending.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    // Decode the requested image right here if it was not prefetched, there
+    // is no point in waiting for a worker.
+    cv::Mat    image;
+    const auto requested  = _pending.find(index);
+    const bool prefetched = requested != _pending.end();
+    if (prefetched) {
+        image = requested->second.image.get();
+        _pending.erase(requested);
+    }
+
+    for (std::size_t i = index + stride; i <= last && i < _files.size();
+         i += stride) {
+        schedule(i);
+    }
+
+    if (!prefetched) {
+        image = cv::imread(_files[index].string(), _flags);
+    }
+    return image;
+}
+
+void ImagePrefetcher::cancel()
+{
+    for (auto& pending : _pending) {
+        *pending.second.cancelled = true;
+    }
+    _pending.clear();
+}
+
+void ImagePrefetcher::setImreadFlags(int flags)
+{
+    if (flags != _flags) {
+        cancel();
+        _flags = flags;
+    }
+}
+
+void ImagePrefetcher::schedule(std::size_t index)
+{
+    if (_pending.count(index)) {
+        return;
+    }
+
+    auto cancelled = std::make_shared<std::atomic<bool>>(false);
+    auto filename  = _files[index].string();
+    auto flags     = _flags;
+    auto image     = _pool.submit([filename, flags, cancelled] {
+        if (*cancelled) {
+            return cv::Mat();
+        }
+        return cv::imread(filename, flags);
+    });
+    _pending.emplace(index, Pending{image.share(), cancelled});
+}
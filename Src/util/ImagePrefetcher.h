@@ -0,0 +1,67 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <boost/filesystem.hpp>
+
+#include <atomic>
+#include <future>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "ThreadPool.h"
+
+/**
+ * Decodes the images following the currently requested one on a pool of
+ * worker threads, so that reading and decoding picture sequences is not
+ * bound to the player thread.
+ *
+ * At most depth images are decoded or held in advance. Images which fall out
+ * of the window, e.g. after a seek, are cancelled or released.
+ */
+class ImagePrefetcher
+{
+public:
+    /**
+     * @param files the picture sequence, must outlive the prefetcher
+     * @param depth number of images decoded in advance
+     * @param threads number of decoder threads, 0 selects the number of
+     * hardware threads
+     */
+    ImagePrefetcher(const std::vector<boost::filesystem::path>& files,
+                    std::size_t                                 depth,
+                    std::size_t                                 threads);
+    ~ImagePrefetcher();
+
+    /**
+     * @return the decoded image at index. Schedules the next depth images
+     * with the given stride.
+     */
+    cv::Mat get(std::size_t index, std::size_t stride);
+
+    /**
+     * Cancels all pending work and releases all prefetched images.
+     */
+    void cancel();
+
+    /**
+     * Sets the cv::imread flags, images prefetched with other flags are
+     * dropped.
+     */
+    void setImreadFlags(int flags);
+
+private:
+    struct Pending
+    {
+        std::shared_future<cv::Mat>        image;
+        std::shared_ptr<std::atomic<bool>> cancelled;
+    };
+
+    void schedule(std::size_t index);
+
+    const std::vector<boost::filesystem::path>& _files;
+    std::size_t                                 _depth;
+    int                                         _flags;
+    std::map<std::size_t, Pending>              _pending;
+    ThreadPool                                  _pool;
+};
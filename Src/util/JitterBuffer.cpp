@@ -0,0 +1,116 @@
+#include "JitterBuffer.h"
+
+JitterBuffer::JitterBuffer(std::size_t               capacity,
+                           std::chrono::milliseconds latency)
+: _capacity(capacity > 0 ? capacity : 1)
+, _latency(latency)
+, _aborted(false)
+, _anchored(false)
+, _basePts(0)
+, _lastPts(-1)
+, _dropped(0)
+, _late(0)
+, _duplicates(0)
+{
+}
+
+void JitterBuffer::push(NetworkFrame frame)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    if (frame.pts >= 0) {
+        if (frame.pts <= _lastPts) {
+            _duplicates++;
+            return;
+        }
+        _lastPts = frame.pts;
+    }
+
+    if (!_anchored && frame.pts >= 0) {
+        _anchored = true;
+        _base     = frame.arrived;
+        _basePts  = frame.pts;
+    } else if (_anchored && frame.pts >= 0) {
+        const Clock::time_point onTime  = due(frame) - _latency;
+        const Clock::time_point playout = due(frame);
+        if (frame.arrived < onTime) {
+            // Faster than any frame before, e.g. catching up after a stall:
+            // move the timeline back, so that a stall does not add to the
+            // latency for the rest of the session
+            _base -= onTime - frame.arrived;
+        } else if (frame.arrived > playout) {
+            // Arrived after its playout time: the sender or the network fell
+            // behind, shift the timeline instead of making every later frame
+            // late, too
+            _base += frame.arrived - playout;
+        }
+    }
+
+    if (_frames.size() >= _capacity) {
+        _frames.pop_front();
+        _dropped++;
+    }
+    _frames.push_back(std::move(frame));
+    _changed.notify_all();
+}
+
+std::optional<NetworkFrame> JitterBuffer::pop(
+    std::chrono::milliseconds timeout)
+{
+    const Clock::time_point deadline = Clock::now() + timeout;
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    for (;;) {
+        if (_aborted) {
+            return std::nullopt;
+        }
+        const Clock::time_point now = Clock::now();
+        if (!_frames.empty() && due(_frames.front()) <= now) {
+            // Only the newest due frame is delivered
+            while (_frames.size() > 1 && due(_frames[1]) <= now) {
+                _frames.pop_front();
+                _late++;
+            }
+            NetworkFrame frame = std::move(_frames.front());
+            _frames.pop_front();
+            return frame;
+        }
+        if (now >= deadline) {
+            return std::nullopt;
+        }
+
+        Clock::time_point wake = deadline;
+        if (!_frames.empty()) {
+            wake = std::min(wake, due(_frames.front()));
+        }
+        _changed.wait_until(lock, wake);
+    }
+}
+
+void JitterBuffer::resync()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _frames.clear();
+    _anchored = false;
+    _lastPts  = -1;
+}
+
+void JitterBuffer::abort()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _aborted = true;
+    _changed.notify_all();
+}
+
+JitterBuffer::Clock::time_point JitterBuffer::due(
+    const NetworkFrame& frame) const
+{
+    if (!_anchored || frame.pts < 0) {
+        return frame.arrived + _latency;
+    }
+    return _base +
+           std::chrono::duration_cast<Clock::duration>(
+               std::chrono::duration<double, std::milli>(frame.pts -
+                                                         _basePts)) +
+           _latency;
+}
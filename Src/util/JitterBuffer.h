@@ -0,0 +1,101 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <optional>
+
+/**
+ * A frame received from a network stream.
+ */
+struct NetworkFrame
+{
+    cv::Mat image;
+    // Presentation time stamp of the sender in ms, negative if unknown
+    double pts;
+    std::chrono::steady_clock::time_point arrived;
+};
+
+/**
+ * Evens out the irregular arrival of network frames by holding each frame
+ * back until its playout time: the arrival of the first frame, plus its
+ * distance to the first frame in presentation time, plus the latency.
+ *
+ * The latency is the knob between latency and smoothness. With 0 every
+ * frame is due on arrival, a consumer falling behind always gets the newest
+ * frame. A larger latency absorbs jitter up to that amount and delivers the
+ * frames at the pace of the sender.
+ *
+ * The timeline follows the fastest transit seen: a frame arriving past its
+ * playout time shifts it later, one arriving earlier than the timeline
+ * expects moves it back, so the delay added by a stall is recovered once
+ * the frames catch up.
+ *
+ * Frames are dropped when the buffer is full (dropped), when a newer frame
+ * is already due as well (late) and when their presentation time does not
+ * advance (duplicate).
+ */
+class JitterBuffer
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    JitterBuffer(std::size_t capacity, std::chrono::milliseconds latency);
+
+    void push(NetworkFrame frame);
+
+    /**
+     * @return the newest frame that is due, waits until one is due.
+     * std::nullopt if none is due within timeout or the buffer was aborted.
+     */
+    std::optional<NetworkFrame> pop(std::chrono::milliseconds timeout);
+
+    /**
+     * Drops all frames and restarts the playout timeline, e.g. after the
+     * sender reconnected and its presentation times start over.
+     */
+    void resync();
+
+    /**
+     * Wakes up a waiting pop(), which then returns std::nullopt.
+     */
+    void abort();
+
+    std::uint64_t dropped() const
+    {
+        return _dropped;
+    }
+    std::uint64_t late() const
+    {
+        return _late;
+    }
+    std::uint64_t duplicates() const
+    {
+        return _duplicates;
+    }
+
+private:
+    Clock::time_point due(const NetworkFrame& frame) const;
+
+    const std::size_t               _capacity;
+    const std::chrono::milliseconds _latency;
+
+    mutable std::mutex       _mutex;
+    std::condition_variable  _changed;
+    std::deque<NetworkFrame> _frames;
+    bool                     _aborted;
+    // Anchor of the playout timeline, set by the first frame after resync
+    bool              _anchored;
+    Clock::time_point _base;
+    double            _basePts;
+    double            _lastPts;
+
+    std::atomic<std::uint64_t> _dropped;
+    std::atomic<std::uint64_t> _late;
+    std::atomic<std::uint64_t> _duplicates;
+};
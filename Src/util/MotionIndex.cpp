@@ -0,0 +1,192 @@
+#include "MotionIndex.h"
+#include "ParallelDecoder.h"
+#include "VideoIndex.h"
+
+#include <algorithm>
+#include <functional>
+#include <sstream>
+#include <string>
+
+const int MotionIndex::ScaledWidth;
+
+namespace
+{
+    const Sidecar::Magic Magic     = {'B', 'T', 'M', 'O', 'T', 'N', '0', '1'};
+    const char*          Extension = ".motion";
+
+    cv::Mat shrink(const cv::Mat& image, cv::Size size)
+    {
+        cv::Mat gray;
+        if (image.channels() == 3) {
+            cv::cvtColor(image, gray, cv::COLOR_BGR2GRAY);
+        } else if (image.channels() == 4) {
+            cv::cvtColor(image, gray, cv::COLOR_BGRA2GRAY);
+        } else {
+            gray = image;
+        }
+        cv::Mat small;
+        cv::resize(gray, small, size, 0, 0, cv::INTER_AREA);
+        return small;
+    }
+
+    float difference(const cv::Mat& a, const cv::Mat& b, const cv::Mat& mask)
+    {
+        cv::Mat diff;
+        cv::absdiff(a, b, diff);
+        return static_cast<float>(cv::mean(diff, mask)[0]);
+    }
+
+    // The frames of one range of the parallel decode
+    struct Range
+    {
+        std::vector<float> scores;
+        cv::Mat            head;
+        cv::Mat            tail;
+    };
+}
+
+std::shared_ptr<MotionIndex> MotionIndex::load(
+    const boost::filesystem::path& video,
+    const cv::Mat&                 mask,
+    const boost::filesystem::path& directory)
+{
+    auto                        index = std::make_shared<MotionIndex>();
+    boost::filesystem::ifstream in;
+    if (!Sidecar::stamp(video, index->_stamp) ||
+        !Sidecar::open(in,
+                       Sidecar::path(video, directory, Extension),
+                       Magic,
+                       index->_stamp)) {
+        return nullptr;
+    }
+
+    std::uint64_t frames;
+    if (!Sidecar::read(in, index->_mask) || !Sidecar::read(in, frames)) {
+        return nullptr;
+    }
+    if (index->_mask != hashMask(mask) || frames == 0) {
+        return nullptr;
+    }
+
+    index->_video = boost::filesystem::absolute(video);
+    index->_scores.resize(frames);
+    if (!in.read(reinterpret_cast<char*>(index->_scores.data()),
+                 frames * sizeof(float))) {
+        return nullptr;
+    }
+    return index;
+}
+
+std::shared_ptr<MotionIndex> MotionIndex::build(
+    const boost::filesystem::path&    video,
+    std::shared_ptr<const VideoIndex> index,
+    const cv::Mat&                    mask,
+    const std::atomic<bool>&          abort)
+{
+    auto motion    = std::make_shared<MotionIndex>();
+    motion->_video = boost::filesystem::absolute(video);
+    motion->_mask  = hashMask(mask);
+    if (!Sidecar::stamp(video, motion->_stamp)) {
+        return nullptr;
+    }
+
+    cv::Size frameSize = mask.size();
+    if (mask.empty()) {
+        cv::VideoCapture capture(video.string());
+        frameSize = cv::Size(
+            static_cast<int>(capture.get(cv::CAP_PROP_FRAME_WIDTH)),
+            static_cast<int>(capture.get(cv::CAP_PROP_FRAME_HEIGHT)));
+    }
+    if (frameSize.width <= 0 || frameSize.height <= 0) {
+        return nullptr;
+    }
+    const int      width = std::min(ScaledWidth, frameSize.width);
+    const cv::Size size(width,
+                        std::max(1,
+                                 frameSize.height * width / frameSize.width));
+    cv::Mat        scaledMask;
+    if (!mask.empty()) {
+        cv::resize(mask, scaledMask, size, 0, 0, cv::INTER_NEAREST);
+    }
+
+    ParallelDecoder decoder(video, std::move(index));
+    cv::Mat         last;
+    const bool      complete = decoder.run<Range>(
+        [&size, &scaledMask](Range&         range,
+                             std::size_t    frame,
+                             const cv::Mat& image) {
+            cv::Mat small = shrink(image, size);
+            if (range.head.empty()) {
+                range.head = small;
+                range.scores.push_back(0);
+            } else {
+                range.scores.push_back(
+                    difference(range.tail, small, scaledMask));
+            }
+            range.tail = small;
+        },
+        [&motion, &last, &scaledMask](Range&& range) {
+            // Ranges are decoded apart, the first frame of a range is
+            // compared to the last one of the range before here
+            if (!last.empty() && !range.scores.empty()) {
+                range.scores.front() = difference(last,
+                                                  range.head,
+                                                  scaledMask);
+            }
+            motion->_scores.insert(motion->_scores.end(),
+                                   range.scores.begin(),
+                                   range.scores.end());
+            if (!range.tail.empty()) {
+                last = range.tail;
+            }
+        },
+        abort);
+    if (!complete || motion->_scores.empty()) {
+        return nullptr;
+    }
+    return motion;
+}
+
+bool MotionIndex::save(const boost::filesystem::path& directory) const
+{
+    return Sidecar::save(Sidecar::path(_video, directory, Extension),
+                         Magic,
+                         _stamp,
+                         [this](std::ostream& out) {
+                             Sidecar::write(out, _mask);
+                             Sidecar::write(
+                                 out,
+                                 static_cast<std::uint64_t>(_scores.size()));
+                             out.write(
+                                 reinterpret_cast<const char*>(_scores.data()),
+                                 _scores.size() * sizeof(float));
+                         });
+}
+
+std::size_t MotionIndex::nextActive(std::size_t frame,
+                                    double      threshold,
+                                    std::size_t padding) const
+{
+    for (std::size_t i = frame > padding ? frame - padding : 0;
+         i < _scores.size();
+         i++) {
+        if (_scores[i] >= threshold) {
+            return std::max(frame, i > padding ? i - padding : 0);
+        }
+    }
+    return _scores.size();
+}
+
+std::uint64_t MotionIndex::hashMask(const cv::Mat& mask)
+{
+    if (mask.empty()) {
+        return 0;
+    }
+    const cv::Mat continuous = mask.isContinuous() ? mask : mask.clone();
+    const auto    data = reinterpret_cast<const char*>(continuous.data);
+    std::stringstream key;
+    key << mask.cols << "x" << mask.rows << ":";
+    return std::hash<std::string>()(
+        key.str() +
+        std::string(data, continuous.total() * continuous.elemSize()));
+}
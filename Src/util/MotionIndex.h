@@ -0,0 +1,86 @@
+#pragma once
+
+#include "Sidecar.h"
+
+#include <opencv2/opencv.hpp>
+#include <boost/filesystem.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class VideoIndex;
+
+/**
+ * Motion energy of every frame of a video: the mean absolute difference to
+ * the frame before, of downsampled grayscale frames inside a mask (e.g. the
+ * aperture). Lets playback skip segments in which nothing moves.
+ *
+ * Building the index decodes the whole video, so it is stored as a sidecar
+ * and reused as long as the video and the mask do not change.
+ */
+class MotionIndex
+{
+public:
+    /**
+     * Width frames are downsampled to before differencing.
+     */
+    static const int ScaledWidth = 160;
+
+    /**
+     * @param mask 8 bit mask of the frame size, empty for the whole frame
+     * @return the index stored for video and mask in directory, or nullptr
+     * if there is none or it is outdated.
+     */
+    static std::shared_ptr<MotionIndex> load(
+        const boost::filesystem::path& video,
+        const cv::Mat&                 mask,
+        const boost::filesystem::path& directory);
+
+    /**
+     * Decodes the whole video, in parallel if its seek index is given.
+     * Returns nullptr if aborted or the video could not be read.
+     */
+    static std::shared_ptr<MotionIndex> build(
+        const boost::filesystem::path&    video,
+        std::shared_ptr<const VideoIndex> index,
+        const cv::Mat&                    mask,
+        const std::atomic<bool>&          abort);
+
+    /**
+     * Writes the index as sidecar for its video into directory.
+     */
+    bool save(const boost::filesystem::path& directory) const;
+
+    std::size_t frameCount() const
+    {
+        return _scores.size();
+    }
+
+    /**
+     * @return mean absolute grey level difference to the frame before, 0
+     * for the first frame.
+     */
+    float score(std::size_t frame) const
+    {
+        return _scores[frame];
+    }
+
+    /**
+     * @return the first frame at or after frame that lies within padding
+     * frames of a frame scoring at least threshold, frameCount() if there
+     * is none.
+     */
+    std::size_t nextActive(std::size_t frame,
+                           double      threshold,
+                           std::size_t padding) const;
+
+private:
+    static std::uint64_t hashMask(const cv::Mat& mask);
+
+    boost::filesystem::path _video;
+    Sidecar::Stamp          _stamp;
+    std::uint64_t           _mask = 0;
+    std::vector<float>      _scores;
+};
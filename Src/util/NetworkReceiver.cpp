@@ -0,0 +1,113 @@
+#include "NetworkReceiver.h"
+
+#include <algorithm>
+
+constexpr std::chrono::milliseconds NetworkReceiver::MinBackoff;
+constexpr std::chrono::milliseconds NetworkReceiver::MaxBackoff;
+
+namespace
+{
+    // Bounds connecting and waiting for a frame, so that a stalled stream
+    // is noticed and stop() does not hang on it
+    const int TimeoutMs = 5000;
+
+    bool open(cv::VideoCapture& capture, const std::string& url)
+    {
+#if CV_VERSION_MAJOR > 4 || (CV_VERSION_MAJOR == 4 && CV_VERSION_MINOR >= 6)
+        const std::vector<int> params = {cv::CAP_PROP_OPEN_TIMEOUT_MSEC,
+                                         TimeoutMs,
+                                         cv::CAP_PROP_READ_TIMEOUT_MSEC,
+                                         TimeoutMs};
+        if (!capture.open(url, cv::CAP_FFMPEG, params)) {
+            return false;
+        }
+#else
+        if (!capture.open(url, cv::CAP_FFMPEG)) {
+            return false;
+        }
+#endif
+        // Frames are buffered in the JitterBuffer, not by the backend
+        capture.set(cv::CAP_PROP_BUFFERSIZE, 1);
+        return true;
+    }
+}
+
+NetworkReceiver::NetworkReceiver(std::string               url,
+                                 std::size_t               capacity,
+                                 std::chrono::milliseconds latency)
+: _url(std::move(url))
+, _buffer(capacity, latency)
+, _abort(false)
+, _fps(0)
+, _reconnects(0)
+{
+}
+
+NetworkReceiver::~NetworkReceiver()
+{
+    stop();
+}
+
+void NetworkReceiver::start()
+{
+    _thread = std::thread(&NetworkReceiver::run, this);
+}
+
+void NetworkReceiver::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _abort = true;
+    }
+    _stopped.notify_all();
+    _buffer.abort();
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+}
+
+bool NetworkReceiver::sleep(std::chrono::milliseconds duration)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    return !_stopped.wait_for(lock, duration, [this] { return _abort; });
+}
+
+bool NetworkReceiver::stopping()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _abort;
+}
+
+void NetworkReceiver::run()
+{
+    std::chrono::milliseconds backoff = MinBackoff;
+    while (!stopping()) {
+        cv::VideoCapture capture;
+        if (!open(capture, _url)) {
+            _reconnects++;
+            if (!sleep(backoff)) {
+                return;
+            }
+            backoff = std::min(backoff * 2, MaxBackoff);
+            continue;
+        }
+        backoff = MinBackoff;
+        _fps    = capture.get(cv::CAP_PROP_FPS);
+        // Presentation times start over with every connection
+        _buffer.resync();
+
+        NetworkFrame frame;
+        while (!stopping() && capture.read(frame.image) &&
+               !frame.image.empty()) {
+            frame.arrived = JitterBuffer::Clock::now();
+            // Backends without time stamps report 0
+            const double pts = capture.get(cv::CAP_PROP_POS_MSEC);
+            frame.pts        = pts > 0 ? pts : -1;
+            _buffer.push(std::move(frame));
+            frame = NetworkFrame();
+        }
+        if (!stopping()) {
+            _reconnects++;
+        }
+    }
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "JitterBuffer.h"
+
+/**
+ * Receives a network stream (RTSP, UDP, HTTP MJPEG, ...) through the FFmpeg
+ * backend of OpenCV on a dedicated thread into a JitterBuffer.
+ *
+ * If the stream cannot be opened or breaks off, the receiver reconnects
+ * with an exponential backoff until it is stopped.
+ */
+class NetworkReceiver
+{
+public:
+    NetworkReceiver(std::string               url,
+                    std::size_t               capacity,
+                    std::chrono::milliseconds latency);
+    ~NetworkReceiver();
+
+    NetworkReceiver(const NetworkReceiver&) = delete;
+    NetworkReceiver& operator=(const NetworkReceiver&) = delete;
+
+    /**
+     * Starts receiving, a receiver is started once.
+     */
+    void start();
+    void stop();
+
+    JitterBuffer& buffer()
+    {
+        return _buffer;
+    }
+
+    /**
+     * Frame rate announced by the stream, 0 if unknown.
+     */
+    double fps() const
+    {
+        return _fps;
+    }
+
+    /**
+     * Number of connections lost or failed.
+     */
+    std::uint64_t reconnects() const
+    {
+        return _reconnects;
+    }
+
+private:
+    void run();
+
+    /**
+     * Waits for duration unless the receiver is stopped meanwhile.
+     * @return false if it was stopped
+     */
+    bool sleep(std::chrono::milliseconds duration);
+    bool stopping();
+
+    static constexpr std::chrono::milliseconds MinBackoff{500};
+    static constexpr std::chrono::milliseconds MaxBackoff{10000};
+
+    std::string                _url;
+    JitterBuffer               _buffer;
+    std::thread                _thread;
+    std::mutex                 _mutex;
+    std::condition_variable    _stopped;
+    bool                       _abort;
+    std::atomic<double>        _fps;
+    std::atomic<std::uint64_t> _reconnects;
+};
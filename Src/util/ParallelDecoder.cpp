@@ -0,0 +1,117 @@
+#include "ParallelDecoder.h"
+#include "VideoIndex.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace
+{
+    // Ranges per worker, a worker done early takes over the next range
+    const std::size_t RangesPerThread = 4;
+}
+
+ParallelDecoder::ParallelDecoder(boost::filesystem::path           file,
+                                 std::shared_ptr<const VideoIndex> index,
+                                 std::size_t                       threads)
+: _file(std::move(file))
+, _index(std::move(index))
+, _threads(threads)
+{
+    if (_threads == 0) {
+        _threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    if (!_index) {
+        cv::VideoCapture  capture(_file.string());
+        const std::size_t frames = static_cast<std::size_t>(
+            std::max(0.0, capture.get(cv::CAP_PROP_FRAME_COUNT)));
+        _ranges.push_back({0, frames});
+        return;
+    }
+
+    const std::size_t frames = _index->frameCount();
+    const std::size_t parts  = std::max<std::size_t>(
+        1,
+        std::min(frames, _threads * RangesPerThread));
+    std::size_t first = 0;
+    for (std::size_t i = 1; i <= parts; i++) {
+        const std::size_t end = i == parts
+                                    ? frames
+                                    : _index->anchorBefore(frames * i / parts);
+        // Long GOPs may end several boundaries at the same anchor
+        if (end > first) {
+            _ranges.push_back({first, end});
+            first = end;
+        }
+    }
+}
+
+bool ParallelDecoder::decode(
+    const Range&                                            range,
+    const std::function<void(std::size_t, const cv::Mat&)>& frame,
+    const std::function<bool()>&                            stopped) const
+{
+    if (range.first >= range.end) {
+        return true;
+    }
+
+    cv::VideoCapture capture;
+#if CV_VERSION_MAJOR > 4 || (CV_VERSION_MAJOR == 4 && CV_VERSION_MINOR >= 7)
+    // The ranges already keep all cores busy
+    if (!capture.open(_file.string(),
+                      cv::CAP_ANY,
+                      {cv::CAP_PROP_N_THREADS, 1})) {
+        return false;
+    }
+#else
+    if (!capture.open(_file.string())) {
+        return false;
+    }
+#endif
+
+    // Frame grabbed last
+    std::size_t position = 0;
+    if (range.first == 0) {
+        if (!capture.grab()) {
+            return false;
+        }
+    } else {
+        std::size_t anchor = range.first;
+        while (true) {
+            capture.set(cv::CAP_PROP_POS_MSEC, _index->timestamp(anchor));
+            if (!capture.grab()) {
+                return false;
+            }
+            position = _index->frameAt(capture.get(cv::CAP_PROP_POS_MSEC));
+            if (position <= range.first) {
+                break;
+            }
+            // The backend landed behind the range, start from the anchor
+            // before
+            if (anchor == 0) {
+                return false;
+            }
+            anchor = _index->anchorBefore(anchor - 1);
+        }
+    }
+    for (; position < range.first; position++) {
+        if (!capture.grab()) {
+            return false;
+        }
+    }
+
+    cv::Mat image;
+    while (true) {
+        if (stopped() || !capture.retrieve(image) || image.empty()) {
+            return false;
+        }
+        frame(position, image);
+        if (++position == range.end) {
+            return true;
+        }
+        if (!capture.grab()) {
+            // The container may announce more frames than it holds
+            return !_index;
+        }
+    }
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "ThreadPool.h"
+
+#include <opencv2/opencv.hpp>
+#include <boost/filesystem.hpp>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+class VideoIndex;
+
+/**
+ * Decodes a whole video on all cores, for offline passes over it such as
+ * background estimation or activity indexing.
+ *
+ * The video is split at anchors (keyframes) of its seek index into ranges,
+ * several per worker so that the workers finish at about the same time.
+ * Every range is decoded by a capture of its own. Without an index the
+ * keyframes are unknown and the video is decoded as a single range.
+ */
+class ParallelDecoder
+{
+public:
+    /**
+     * Frames first to end - 1.
+     */
+    struct Range
+    {
+        std::size_t first;
+        std::size_t end;
+    };
+
+    /**
+     * @param threads number of workers, 0 selects the number of hardware
+     * threads.
+     */
+    ParallelDecoder(boost::filesystem::path           file,
+                    std::shared_ptr<const VideoIndex> index,
+                    std::size_t                       threads = 0);
+
+    const std::vector<Range>& ranges() const
+    {
+        return _ranges;
+    }
+
+    /**
+     * Decodes all frames. The frames of a range are passed in order to
+     * map(State&, std::size_t frame, const cv::Mat& image) on a worker, with
+     * a State of the range. On the calling thread every State is then passed
+     * to reduce(State&&), in the order of the ranges.
+     * @return false if aborted or a range could not be decoded, no further
+     * ranges are reduced then.
+     */
+    template<typename State, typename Map, typename Reduce>
+    bool run(Map map, Reduce reduce, const std::atomic<bool>& abort)
+    {
+        std::atomic<bool> failed(false);
+        const auto        stopped = [&abort, &failed] {
+            return abort.load() || failed.load();
+        };
+
+        // Declared after what the workers use, so its destructor waits for
+        // them before that goes away
+        ThreadPool                                       pool(_threads);
+        std::vector<std::future<std::pair<bool, State>>> results;
+        for (const Range& range : _ranges) {
+            results.push_back(pool.submit([this, range, &map, &stopped] {
+                State      state;
+                const bool complete = decode(
+                    range,
+                    [&map, &state](std::size_t frame, const cv::Mat& image) {
+                        map(state, frame, image);
+                    },
+                    stopped);
+                return std::make_pair(complete, std::move(state));
+            }));
+        }
+
+        for (auto& result : results) {
+            auto range = result.get();
+            if (!range.first || abort) {
+                failed = true;
+                return false;
+            }
+            reduce(std::move(range.second));
+        }
+        return true;
+    }
+
+private:
+    /**
+     * Decodes range with a capture of its own.
+     * @return false if stopped or a frame could not be decoded.
+     */
+    bool decode(
+        const Range&                                          range,
+        const std::function<void(std::size_t, const cv::Mat&)>& frame,
+        const std::function<bool()>&                          stopped) const;
+
+    boost::filesystem::path           _file;
+    std::shared_ptr<const VideoIndex> _index;
+    std::size_t                       _threads;
+    std::vector<Range>                _ranges;
+};
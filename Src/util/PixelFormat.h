@@ -0,0 +1,85 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+
+#include <QMetaType>
+#include <QString>
+
+/**
+ * Pixel format of the frames delivered by an ImageStream. Tracker plugins can
+ * request one through the "inputPixelFormat" property ("BGR", "GRAY8" or
+ * "RAW"), the default is taken from Config::InputPixelFormat.
+ */
+enum class PixelFormat
+{
+    BGR,
+    Gray8,
+    // Whatever the source delivers, e.g. Bayer or mono camera images
+    Raw
+};
+
+Q_DECLARE_METATYPE(PixelFormat);
+
+inline PixelFormat pixelFormatFromString(const QString& name)
+{
+    if (name.compare("GRAY8", Qt::CaseInsensitive) == 0) {
+        return PixelFormat::Gray8;
+    }
+    if (name.compare("RAW", Qt::CaseInsensitive) == 0) {
+        return PixelFormat::Raw;
+    }
+    return PixelFormat::BGR;
+}
+
+/**
+ * @return image in the given format, image itself if it already is.
+ */
+inline cv::Mat convertPixelFormat(const cv::Mat& image, PixelFormat format)
+{
+    if (image.empty()) {
+        return image;
+    }
+
+    cv::Mat converted;
+    switch (format) {
+    case PixelFormat::Gray8:
+        if (image.channels() == 3) {
+            cv::cvtColor(image, converted, cv::COLOR_BGR2GRAY);
+            return converted;
+        }
+        if (image.channels() == 4) {
+            cv::cvtColor(image, converted, cv::COLOR_BGRA2GRAY);
+            return converted;
+        }
+        return image;
+    case PixelFormat::BGR:
+        if (image.channels() == 1) {
+            cv::cvtColor(image, converted, cv::COLOR_GRAY2BGR);
+            return converted;
+        }
+        if (image.channels() == 4) {
+            cv::cvtColor(image, converted, cv::COLOR_BGRA2BGR);
+            return converted;
+        }
+        return image;
+    case PixelFormat::Raw:
+    default:
+        return image;
+    }
+}
+
+/**
+ * @return the cv::imread flags decoding straight into format.
+ */
+inline int imreadFlags(PixelFormat format)
+{
+    switch (format) {
+    case PixelFormat::Gray8:
+        return cv::IMREAD_GRAYSCALE;
+    case PixelFormat::Raw:
+        return cv::IMREAD_UNCHANGED;
+    case PixelFormat::BGR:
+    default:
+        return cv::IMREAD_COLOR;
+    }
+}
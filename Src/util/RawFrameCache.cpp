@@ -0,0 +1,335 @@
+#include "RawFrameCache.h"
+#include "Sidecar.h"
+
+#include <boost/filesystem/fstream.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    const char          Magic[8]  = {'B', 'T', 'R', 'A', 'W', 'F', 'R', 'M'};
+    const std::uint32_t Version   = 1;
+    const char*         Extension = ".btraw";
+
+    std::uint64_t alignUp(std::uint64_t value, std::uint64_t alignment)
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    void pad(std::ostream& out, std::uint64_t alignment)
+    {
+        const std::uint64_t position = static_cast<std::uint64_t>(out.tellp());
+        const std::vector<char> zeros(alignUp(position, alignment) - position);
+        out.write(zeros.data(), zeros.size());
+    }
+}
+
+/**
+ * Releases the cache once the last cv::Mat referencing it is released.
+ */
+class RawFrameCache::MappingAllocator : public cv::MatAllocator
+{
+public:
+#if CV_VERSION_MAJOR >= 4
+    using AccessFlag = cv::AccessFlag;
+#else
+    using AccessFlag = int;
+#endif
+
+    static MappingAllocator* instance()
+    {
+        // Never destroyed, images may be released during static destruction
+        static MappingAllocator* allocator = new MappingAllocator();
+        return allocator;
+    }
+
+    cv::UMatData* allocate(int                dims,
+                           const int*         sizes,
+                           int                type,
+                           void*              data,
+                           size_t*            step,
+                           AccessFlag         flags,
+                           cv::UMatUsageFlags usageFlags) const override
+    {
+        return cv::Mat::getStdAllocator()->allocate(
+            dims, sizes, type, data, step, flags, usageFlags);
+    }
+
+    bool allocate(cv::UMatData*      data,
+                  AccessFlag         accessFlags,
+                  cv::UMatUsageFlags usageFlags) const override
+    {
+        return cv::Mat::getStdAllocator()->allocate(
+            data, accessFlags, usageFlags);
+    }
+
+    void deallocate(cv::UMatData* u) const override
+    {
+        if (!u) {
+            return;
+        }
+        delete static_cast<std::shared_ptr<const RawFrameCache>*>(
+            u->userdata);
+        delete u;
+    }
+};
+
+std::shared_ptr<RawFrameCache> RawFrameCache::open(
+    const boost::filesystem::path& video,
+    const boost::filesystem::path& directory)
+{
+    namespace fs  = boost::filesystem;
+    namespace bip = boost::interprocess;
+
+    const auto                path = location(video, directory);
+    boost::system::error_code ec;
+    const auto                size        = fs::file_size(video, ec);
+    const auto                mtime       = fs::last_write_time(video, ec);
+    const auto                mappingSize = fs::file_size(path, ec);
+    if (ec || mappingSize < sizeof(Header)) {
+        return nullptr;
+    }
+
+    auto cache = std::make_shared<RawFrameCache>();
+    try {
+        cache->_file   = bip::file_mapping(path.string().c_str(),
+                                         bip::read_only);
+        cache->_region = bip::mapped_region(cache->_file, bip::copy_on_write);
+    } catch (const bip::interprocess_exception&) {
+        return nullptr;
+    }
+
+    const char* base = static_cast<const char*>(cache->_region.get_address());
+    const auto* header = reinterpret_cast<const Header*>(base);
+    if (std::memcmp(header->magic, Magic, sizeof(Magic)) != 0 ||
+        header->version != Version || header->sourceSize != size ||
+        header->sourceMtime != static_cast<std::int64_t>(mtime) ||
+        header->frameCount == 0 ||
+        header->tableOffset + header->frameCount * sizeof(std::uint64_t) >
+            mappingSize) {
+        return nullptr;
+    }
+
+    const auto* offsets = reinterpret_cast<const std::uint64_t*>(
+        base + header->tableOffset);
+    const std::uint64_t frameBytes = static_cast<std::uint64_t>(
+        cv::Mat(1, 1, header->type).elemSize() * header->width *
+        header->height);
+    for (std::uint64_t i = 0; i < header->frameCount; i++) {
+        if (offsets[i] + frameBytes > header->tableOffset) {
+            return nullptr;
+        }
+    }
+
+    cache->_header  = header;
+    cache->_offsets = offsets;
+
+    // The modification time orders the caches for eviction
+    fs::last_write_time(path, std::time(nullptr), ec);
+    return cache;
+}
+
+std::unique_ptr<RawFrameCache::Writer> RawFrameCache::Writer::start(
+    const boost::filesystem::path& video,
+    const boost::filesystem::path& directory,
+    const cv::Mat&                 first,
+    std::size_t                    frameCount,
+    double                         fps,
+    bool                           grayscale,
+    std::uintmax_t                 budgetBytes)
+{
+    namespace fs = boost::filesystem;
+
+    if (first.empty()) {
+        return nullptr;
+    }
+
+    std::unique_ptr<Writer> writer(new Writer());
+    Header&                 header = writer->_header;
+    std::memcpy(header.magic, Magic, sizeof(Magic));
+    header.version = Version;
+    header.fps     = fps;
+
+    boost::system::error_code ec;
+    header.sourceSize  = fs::file_size(video, ec);
+    header.sourceMtime = fs::last_write_time(video, ec);
+    fs::create_directories(directory, ec);
+    if (ec) {
+        return nullptr;
+    }
+
+    header.width  = static_cast<std::uint32_t>(first.cols);
+    header.height = static_cast<std::uint32_t>(first.rows);
+    header.type   = static_cast<std::uint32_t>(
+        grayscale && first.channels() == 3 ? CV_8UC1 : first.type());
+
+    // The frame count reported by the container is only good for an
+    // estimate
+    const std::uint64_t pageSize =
+        boost::interprocess::mapped_region::get_page_size();
+    const std::uint64_t frameBytes =
+        first.total() * cv::Mat(1, 1, static_cast<int>(header.type))
+                            .elemSize();
+    const std::uint64_t estimate =
+        alignUp(frameBytes, pageSize) *
+        std::max<std::uint64_t>(1, frameCount);
+    if (estimate > budgetBytes) {
+        return nullptr;
+    }
+    evict(directory, budgetBytes - estimate);
+
+    writer->_directory   = directory;
+    writer->_grayscale   = grayscale;
+    writer->_budgetBytes = budgetBytes;
+    writer->_target      = location(video, directory);
+    writer->_temp        = writer->_target;
+    writer->_temp += fs::unique_path(".%%%%%%");
+    writer->_out.open(writer->_temp, std::ios::binary | std::ios::trunc);
+    writer->_out.write(reinterpret_cast<const char*>(&header),
+                       sizeof(header));
+    if (!writer->_out) {
+        return nullptr;
+    }
+    return writer;
+}
+
+RawFrameCache::Writer::~Writer()
+{
+    if (!_temp.empty()) {
+        _out.close();
+        boost::system::error_code ec;
+        boost::filesystem::remove(_temp, ec);
+    }
+}
+
+bool RawFrameCache::Writer::append(const cv::Mat& image)
+{
+    cv::Mat frame = image;
+    if (_grayscale && frame.channels() == 3) {
+        cv::cvtColor(frame, frame, cv::COLOR_BGR2GRAY);
+    }
+    if (!frame.isContinuous()) {
+        frame = frame.clone();
+    }
+    if (frame.type() != static_cast<int>(_header.type) ||
+        frame.cols != static_cast<int>(_header.width) ||
+        frame.rows != static_cast<int>(_header.height)) {
+        return false;
+    }
+
+    const std::uint64_t pageSize =
+        boost::interprocess::mapped_region::get_page_size();
+    pad(_out, pageSize);
+    _offsets.push_back(static_cast<std::uint64_t>(_out.tellp()));
+    _out.write(reinterpret_cast<const char*>(frame.data),
+               frame.total() * frame.elemSize());
+    return _out && static_cast<std::uint64_t>(_out.tellp()) <= _budgetBytes;
+}
+
+bool RawFrameCache::Writer::finish()
+{
+    namespace fs = boost::filesystem;
+
+    if (_offsets.empty() || !_out) {
+        return false;
+    }
+    pad(_out, sizeof(std::uint64_t));
+    _header.frameCount  = _offsets.size();
+    _header.tableOffset = static_cast<std::uint64_t>(_out.tellp());
+    _out.write(reinterpret_cast<const char*>(_offsets.data()),
+               _offsets.size() * sizeof(std::uint64_t));
+    _out.seekp(0);
+    _out.write(reinterpret_cast<const char*>(&_header), sizeof(_header));
+    _out.close();
+    if (!_out) {
+        return false;
+    }
+
+    boost::system::error_code ec;
+    fs::rename(_temp, _target, ec);
+    if (ec) {
+        return false;
+    }
+    _temp.clear();
+
+    // The estimate may have been short, the new cache is evicted last
+    evict(_directory, _budgetBytes);
+    return true;
+}
+
+std::size_t RawFrameCache::frameCount() const
+{
+    return static_cast<std::size_t>(_header->frameCount);
+}
+
+double RawFrameCache::fps() const
+{
+    return _header->fps;
+}
+
+cv::Mat RawFrameCache::frame(std::size_t index) const
+{
+    if (index >= frameCount()) {
+        return cv::Mat();
+    }
+    char*   base = static_cast<char*>(_region.get_address());
+    cv::Mat view(static_cast<int>(_header->height),
+                 static_cast<int>(_header->width),
+                 static_cast<int>(_header->type),
+                 base + _offsets[index]);
+
+    // Hand the image a reference count of its own, which holds the mapping
+    auto* u     = new cv::UMatData(MappingAllocator::instance());
+    u->data     = view.data;
+    u->origdata = u->data;
+    u->size     = view.total() * view.elemSize();
+    u->flags |= cv::UMatData::USER_ALLOCATED;
+    u->userdata = new std::shared_ptr<const RawFrameCache>(
+        shared_from_this());
+    u->refcount = 1;
+    view.u      = u;
+    return view;
+}
+
+boost::filesystem::path RawFrameCache::location(
+    const boost::filesystem::path& video,
+    const boost::filesystem::path& directory)
+{
+    return Sidecar::path(video, directory, Extension);
+}
+
+void RawFrameCache::evict(const boost::filesystem::path& directory,
+                          std::uintmax_t                 budgetBytes)
+{
+    namespace fs = boost::filesystem;
+
+    // (last use, size, path) of all complete caches
+    std::vector<std::tuple<std::time_t, std::uintmax_t, fs::path>> caches;
+    std::uintmax_t            used = 0;
+    boost::system::error_code ec;
+    for (fs::directory_iterator it(directory, ec), end; !ec && it != end;
+         it.increment(ec)) {
+        const auto& path = it->path();
+        if (path.extension() != Extension) {
+            continue;
+        }
+        const auto size = fs::file_size(path, ec);
+        caches.emplace_back(fs::last_write_time(path, ec), size, path);
+        used += size;
+    }
+
+    std::sort(caches.begin(), caches.end());
+    for (const auto& cache : caches) {
+        if (used <= budgetBytes) {
+            break;
+        }
+        if (fs::remove(std::get<2>(cache), ec)) {
+            used -= std::get<1>(cache);
+        }
+    }
+}
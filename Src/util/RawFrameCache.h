@@ -0,0 +1,143 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <boost/filesystem/fstream.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * Decoded frames of a video, stored raw in a memory mapped file so that
+ * repeated runs on the same video do not need to decode it again.
+ *
+ * The file starts with a fixed header, followed by the frames, each starting
+ * on a page boundary, and the table of frame offsets. Frames are served as
+ * cv::Mat headers over the mapped pages, which keep the mapping alive while
+ * they are referenced. The mapping is copy-on-write, so consumers drawing
+ * into a frame do not alter the file.
+ *
+ * The cache directory is kept within a disk budget by removing the least
+ * recently used files.
+ */
+class RawFrameCache : public std::enable_shared_from_this<RawFrameCache>
+{
+    struct Header
+    {
+        char          magic[8];
+        std::uint32_t version;
+        std::uint32_t width;
+        std::uint32_t height;
+        std::uint32_t type;
+        std::uint64_t frameCount;
+        std::uint64_t tableOffset;
+        std::uint64_t sourceSize;
+        std::int64_t  sourceMtime;
+        double        fps;
+    };
+
+public:
+    /**
+     * Writes the cache of a video from its frames as they are decoded
+     * anyway, in order from the first one. The cache only becomes visible
+     * to open() when it is finished; an unfinished one is removed.
+     */
+    class Writer
+    {
+    public:
+        /**
+         * Starts the cache of video in directory. Older caches are evicted
+         * to keep the directory within budgetBytes, videos which do not fit
+         * at all are not cached.
+         * @param frameCount number of frames expected, for the estimate
+         * @param grayscale store single channel frames instead of the
+         * decoded colour frames
+         * @return nullptr if the video cannot be cached.
+         */
+        static std::unique_ptr<Writer> start(
+            const boost::filesystem::path& video,
+            const boost::filesystem::path& directory,
+            const cv::Mat&                 first,
+            std::size_t                    frameCount,
+            double                         fps,
+            bool                           grayscale,
+            std::uintmax_t                 budgetBytes);
+
+        ~Writer();
+
+        Writer(const Writer&) = delete;
+        Writer& operator=(const Writer&) = delete;
+
+        /**
+         * Number of frames written so far, the next frame to append.
+         */
+        std::size_t frameCount() const
+        {
+            return _offsets.size();
+        }
+
+        /**
+         * @return false if the frame does not match the first one or the
+         * budget is exceeded, the cache cannot be finished then.
+         */
+        bool append(const cv::Mat& frame);
+
+        /**
+         * Completes the cache with the frames appended so far.
+         */
+        bool finish();
+
+    private:
+        Writer() = default;
+
+        boost::filesystem::path     _target;
+        boost::filesystem::path     _temp;
+        boost::filesystem::path     _directory;
+        boost::filesystem::ofstream _out;
+        Header                      _header      = {};
+        bool                        _grayscale   = false;
+        std::uintmax_t              _budgetBytes = 0;
+        std::vector<std::uint64_t>  _offsets;
+    };
+
+    /**
+     * @return the complete and up to date cache of video in directory, or
+     * nullptr if there is none.
+     */
+    static std::shared_ptr<RawFrameCache> open(
+        const boost::filesystem::path& video,
+        const boost::filesystem::path& directory);
+
+    std::size_t frameCount() const;
+
+    double fps() const;
+
+    /**
+     * @return the frame at index, referencing the mapped memory. The cache
+     * stays mapped until the last copy of the image header is released.
+     */
+    cv::Mat frame(std::size_t index) const;
+
+private:
+    class MappingAllocator;
+
+    static boost::filesystem::path location(
+        const boost::filesystem::path& video,
+        const boost::filesystem::path& directory);
+
+    /**
+     * Removes the least recently used caches until at most budgetBytes are
+     * used in directory.
+     */
+    static void evict(const boost::filesystem::path& directory,
+                      std::uintmax_t                 budgetBytes);
+
+    boost::interprocess::file_mapping  _file;
+    boost::interprocess::mapped_region _region;
+    const Header*                      _header  = nullptr;
+    const std::uint64_t*               _offsets = nullptr;
+};
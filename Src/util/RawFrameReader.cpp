@@ -0,0 +1,86 @@
+#include "RawFrameReader.h"
+
+#include <cstdio>
+#include <thread>
+
+#ifdef _WIN32
+    #include <fcntl.h>
+    #include <io.h>
+#endif
+
+RawFrameReader::RawFrameReader(const std::string& path,
+                               cv::Size           size,
+                               int                type,
+                               std::size_t        depth,
+                               cv::MatAllocator*  allocator)
+: _shared(std::make_shared<Shared>(depth))
+{
+    std::thread(&RawFrameReader::run, _shared, path, size, type, allocator)
+        .detach();
+}
+
+RawFrameReader::~RawFrameReader()
+{
+    // Wakes up the thread if it waits for space, it exits on its next push
+    _shared->ring.abort();
+}
+
+std::optional<cv::Mat> RawFrameReader::pop()
+{
+    return _shared->ring.pop();
+}
+
+std::optional<cv::Mat> RawFrameReader::popFor(
+    std::chrono::milliseconds timeout)
+{
+    return _shared->ring.popFor(timeout);
+}
+
+bool RawFrameReader::ended() const
+{
+    return _shared->ring.closed() && _shared->ring.size() == 0;
+}
+
+void RawFrameReader::run(std::shared_ptr<Shared> shared,
+                         std::string             path,
+                         cv::Size                size,
+                         int                     type,
+                         cv::MatAllocator*       allocator)
+{
+    std::FILE* in = nullptr;
+    if (path == "-") {
+        in = stdin;
+#ifdef _WIN32
+        _setmode(_fileno(stdin), _O_BINARY);
+#endif
+    } else {
+        // Opening a named pipe blocks until the writer opened it, too
+        in = std::fopen(path.c_str(), "rb");
+    }
+    if (!in) {
+        shared->ring.close();
+        return;
+    }
+    // Frames are read whole, buffering would only add a copy
+    std::setvbuf(in, nullptr, _IONBF, 0);
+
+    for (;;) {
+        // With a FramePool the buffer of a released frame is reused
+        cv::Mat frame;
+        frame.allocator = allocator;
+        frame.create(size, type);
+        const std::size_t bytes = frame.total() * frame.elemSize();
+        // A partial frame at the end of the stream is dropped
+        if (std::fread(frame.data, 1, bytes, in) != bytes) {
+            break;
+        }
+        if (!shared->ring.push(frame)) {
+            break;
+        }
+    }
+
+    if (in != stdin) {
+        std::fclose(in);
+    }
+    shared->ring.close();
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <string>
+
+#include "FrameRing.h"
+
+/**
+ * Reads fixed size raw frames, e.g. the rawvideo output of ffmpeg, from
+ * stdin or a named pipe on a dedicated thread into a bounded ring.
+ *
+ * Each frame is read with a single large read straight into its buffer,
+ * which comes from the given allocator, e.g. a FramePool. The
+ * thread is detached: a read blocked on an idle pipe never holds up the
+ * destruction of the reader, the thread ends with the next read.
+ */
+class RawFrameReader
+{
+public:
+    /**
+     * @param path "-" for stdin, otherwise the file or pipe to read
+     * @param type OpenCV type of the frames, e.g. CV_8UC3 for bgr24
+     * @param allocator allocates the frames, nullptr for the default
+     * allocation
+     */
+    RawFrameReader(const std::string& path,
+                   cv::Size           size,
+                   int                type,
+                   std::size_t        depth,
+                   cv::MatAllocator*  allocator = nullptr);
+    ~RawFrameReader();
+
+    RawFrameReader(const RawFrameReader&) = delete;
+    RawFrameReader& operator=(const RawFrameReader&) = delete;
+
+    /**
+     * @return the next frame, waits if none was read yet. std::nullopt
+     * signals the end of the stream.
+     */
+    std::optional<cv::Mat> pop();
+
+    /**
+     * Like pop(), but gives up after the timeout.
+     */
+    std::optional<cv::Mat> popFor(std::chrono::milliseconds timeout);
+
+    /**
+     * @return true if the stream ended and all frames were popped.
+     */
+    bool ended() const;
+
+private:
+    struct Shared
+    {
+        explicit Shared(std::size_t depth)
+        : ring(depth)
+        {
+        }
+
+        FrameRing<cv::Mat> ring;
+    };
+
+    static void run(std::shared_ptr<Shared> shared,
+                    std::string             path,
+                    cv::Size                size,
+                    int                     type,
+                    cv::MatAllocator*       allocator);
+
+    std::shared_ptr<Shared> _shared;
+};
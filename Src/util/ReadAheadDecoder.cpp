@@ -0,0 +1,67 @@
+#include "ReadAheadDecoder.h"
+#include "StridedRead.h"
+
+ReadAheadDecoder::ReadAheadDecoder(std::size_t depth)
+: _ring(depth)
+, _abort(false)
+, _capture(nullptr)
+, _stride(1)
+, _allocator(nullptr)
+{
+}
+
+ReadAheadDecoder::~ReadAheadDecoder()
+{
+    stop();
+}
+
+void ReadAheadDecoder::start(cv::VideoCapture* capture,
+                             std::size_t       stride,
+                             cv::MatAllocator* allocator)
+{
+    stop();
+
+    _capture   = capture;
+    _stride    = stride > 0 ? stride : 1;
+    _allocator = allocator;
+    _abort     = false;
+    _ring.reset();
+    _thread = std::thread(&ReadAheadDecoder::run, this);
+}
+
+void ReadAheadDecoder::stop()
+{
+    _abort = true;
+    _ring.abort();
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+    _ring.reset();
+}
+
+bool ReadAheadDecoder::running() const
+{
+    return _thread.joinable();
+}
+
+cv::Mat ReadAheadDecoder::pop()
+{
+    auto frame = _ring.pop();
+    return frame ? *frame : cv::Mat();
+}
+
+void ReadAheadDecoder::run()
+{
+    while (!_abort) {
+        cv::Mat frame = readStrided(*_capture, _stride, _allocator);
+
+        if (frame.empty()) {
+            _ring.close();
+            return;
+        }
+
+        if (!_ring.push(frame)) {
+            return;
+        }
+    }
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+
+#include <atomic>
+#include <thread>
+
+#include "FrameRing.h"
+
+/**
+ * Decodes frames of a cv::VideoCapture on a dedicated thread into a bounded
+ * ring, so that decoding the next frames overlaps with processing the current
+ * one.
+ *
+ * While the decoder is running it owns the capture: the caller must stop() it
+ * before touching the capture again (seeking, reopening, ...).
+ */
+class ReadAheadDecoder
+{
+public:
+    explicit ReadAheadDecoder(std::size_t depth);
+    ~ReadAheadDecoder();
+
+    ReadAheadDecoder(const ReadAheadDecoder&) = delete;
+    ReadAheadDecoder& operator=(const ReadAheadDecoder&) = delete;
+
+    /**
+     * Starts decoding at the capture's current position. Each queued frame is
+     * the last of stride consecutive frames, the others are only grabbed.
+     * Frames are allocated by allocator, nullptr for the default allocation.
+     */
+    void start(cv::VideoCapture* capture,
+               std::size_t       stride,
+               cv::MatAllocator* allocator = nullptr);
+
+    /**
+     * Stops the decoder thread and discards all frames read ahead.
+     */
+    void stop();
+
+    bool running() const;
+
+    /**
+     * @return the next decoded frame, waits if none is ready yet. An empty
+     * frame signals the end of the stream.
+     */
+    cv::Mat pop();
+
+private:
+    void run();
+
+    FrameRing<cv::Mat> _ring;
+    std::thread        _thread;
+    std::atomic<bool>  _abort;
+    cv::VideoCapture*  _capture;
+    std::size_t        _stride;
+    cv::MatAllocator*  _allocator;
+};
@@ -0,0 +1,72 @@
+#include "ReverseDecoder.h"
+#include "VideoIndex.h"
+
+#include <algorithm>
+
+ReverseDecoder::ReverseDecoder(const boost::filesystem::path&    file,
+                               std::shared_ptr<const VideoIndex> index,
+                               std::size_t                       segment)
+: _capture(file.string())
+, _index(std::move(index))
+, _segment(std::max<std::size_t>(segment, 1))
+{
+}
+
+ReverseDecoder::~ReverseDecoder()
+{
+    // The worker uses the capture
+    if (_previous.valid()) {
+        _previous.wait();
+    }
+}
+
+cv::Mat ReverseDecoder::frame(std::size_t number)
+{
+    if (!_current.contains(number)) {
+        if (_previous.valid()) {
+            _current = _previous.get();
+        }
+        if (!_current.contains(number)) {
+            _current = decode(number);
+        }
+    }
+    if (!_current.contains(number)) {
+        return cv::Mat();
+    }
+
+    if (_current.first > 0 && !_previous.valid()) {
+        const std::size_t last = _current.first - 1;
+        _previous = std::async(std::launch::async,
+                               [this, last] { return decode(last); });
+    }
+    return _current.frames[number - _current.first];
+}
+
+ReverseDecoder::Segment ReverseDecoder::decode(std::size_t last)
+{
+    std::size_t anchor;
+    if (_index && last < _index->frameCount()) {
+        anchor = _index->anchorBefore(last);
+    } else {
+        anchor = last - last % _segment;
+    }
+
+    Segment segment;
+    segment.first = std::max(anchor, last + 1 - std::min(last + 1, _segment));
+
+    // Seeking to the anchor itself only decodes from there
+    _capture.set(cv::CAP_PROP_POS_FRAMES, static_cast<double>(anchor));
+    for (std::size_t i = anchor; i < segment.first; i++) {
+        if (!_capture.grab()) {
+            return Segment();
+        }
+    }
+    for (std::size_t i = segment.first; i <= last; i++) {
+        cv::Mat frame;
+        if (!_capture.read(frame) || frame.empty()) {
+            break;
+        }
+        segment.frames.push_back(frame);
+    }
+    return segment;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <boost/filesystem.hpp>
+
+#include <future>
+#include <memory>
+#include <vector>
+
+class VideoIndex;
+
+/**
+ * Serves the frames of a video backwards at close to forward speed.
+ *
+ * Frames are decoded forwards in segments that start at an anchor (keyframe)
+ * of the seek index, or every segment frames without one, and are handed
+ * out from memory. While a segment is played back, the one before it is
+ * decoded on a worker thread. At most two segments of at most segment frames
+ * each are held: a segment of a longer GOP is decoded from its keyframe, but
+ * only its last frames are kept.
+ *
+ * The decoder opens the video a second time, so the capture of the stream
+ * stays where forward playback left it.
+ */
+class ReverseDecoder
+{
+public:
+    ReverseDecoder(const boost::filesystem::path&    file,
+                   std::shared_ptr<const VideoIndex> index,
+                   std::size_t                       segment);
+    ~ReverseDecoder();
+
+    ReverseDecoder(const ReverseDecoder&) = delete;
+    ReverseDecoder& operator=(const ReverseDecoder&) = delete;
+
+    bool isOpened() const
+    {
+        return _capture.isOpened();
+    }
+
+    /**
+     * @return the frame, decoding its segment unless it is held or being
+     * decoded ahead; an empty image if it cannot be decoded. Starts
+     * decoding the segment before on the worker.
+     */
+    cv::Mat frame(std::size_t number);
+
+private:
+    struct Segment
+    {
+        std::size_t          first = 0;
+        std::vector<cv::Mat> frames;
+
+        bool contains(std::size_t number) const
+        {
+            return number >= first && number - first < frames.size();
+        }
+    };
+
+    /**
+     * Decodes the segment ending with frame last.
+     */
+    Segment decode(std::size_t last);
+
+    cv::VideoCapture                  _capture;
+    std::shared_ptr<const VideoIndex> _index;
+    const std::size_t                 _segment;
+    Segment                           _current;
+    // The segment before _current, decoded on the worker
+    std::future<Segment> _previous;
+};
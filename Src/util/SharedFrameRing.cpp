@@ -0,0 +1,312 @@
+#include "SharedFrameRing.h"
+
+#include <cstring>
+#include <new>
+
+namespace
+{
+    const char Magic[8] = {'B', 'T', 'S', 'H', 'M', 'R', 'N', 'G'};
+
+    // Producer and consumer are different processes, locking atomics would
+    // not synchronize them
+    static_assert(std::atomic<std::uint64_t>::is_always_lock_free &&
+                      std::atomic<std::uint32_t>::is_always_lock_free,
+                  "Atomics in shared memory must be lock free");
+
+    std::uint64_t alignUp(std::uint64_t value, std::uint64_t alignment)
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+}
+
+/**
+ * Unpins a slot once the last cv::Mat referencing it is released.
+ */
+class SharedFrameRing::SlotAllocator : public cv::MatAllocator
+{
+public:
+#if CV_VERSION_MAJOR >= 4
+    using AccessFlag = cv::AccessFlag;
+#else
+    using AccessFlag = int;
+#endif
+
+    struct Pin
+    {
+        // Keeps the mapping alive while the image is referenced
+        std::shared_ptr<SharedFrameRing> ring;
+        SlotHeader*                      slot;
+    };
+
+    static SlotAllocator* instance()
+    {
+        // Never destroyed, images may be released during static destruction
+        static SlotAllocator* allocator = new SlotAllocator();
+        return allocator;
+    }
+
+    cv::UMatData* allocate(int                dims,
+                           const int*         sizes,
+                           int                type,
+                           void*              data,
+                           size_t*            step,
+                           AccessFlag         flags,
+                           cv::UMatUsageFlags usageFlags) const override
+    {
+        return cv::Mat::getStdAllocator()->allocate(
+            dims, sizes, type, data, step, flags, usageFlags);
+    }
+
+    bool allocate(cv::UMatData*      data,
+                  AccessFlag         accessFlags,
+                  cv::UMatUsageFlags usageFlags) const override
+    {
+        return cv::Mat::getStdAllocator()->allocate(
+            data, accessFlags, usageFlags);
+    }
+
+    void deallocate(cv::UMatData* u) const override
+    {
+        if (!u) {
+            return;
+        }
+        Pin* pin = static_cast<Pin*>(u->userdata);
+        pin->slot->state.store(Ready, std::memory_order_release);
+        delete pin;
+        delete u;
+    }
+};
+
+std::shared_ptr<SharedFrameRing> SharedFrameRing::create(
+    const std::string& name,
+    std::uint32_t      slotCount,
+    std::uint64_t      frameBytes,
+    double             fps)
+{
+    namespace bip = boost::interprocess;
+
+    if (slotCount < 2) {
+        return nullptr;
+    }
+
+    const std::uint64_t page        = bip::mapped_region::get_page_size();
+    const std::uint64_t slotsOffset = alignUp(sizeof(Header), page);
+    const std::uint64_t dataOffset  = alignUp(sizeof(SlotHeader), 64);
+    const std::uint64_t slotBytes   = alignUp(dataOffset + frameBytes, page);
+
+    auto ring = std::make_shared<SharedFrameRing>();
+    try {
+        bip::shared_memory_object::remove(name.c_str());
+        ring->_shm   = bip::shared_memory_object(bip::create_only,
+                                               name.c_str(),
+                                               bip::read_write);
+        ring->_name  = name;
+        ring->_owner = true;
+        ring->_shm.truncate(slotsOffset + slotBytes * slotCount);
+        ring->_region = bip::mapped_region(ring->_shm, bip::read_write);
+    } catch (const bip::interprocess_exception&) {
+        return nullptr;
+    }
+
+    char* base    = static_cast<char*>(ring->_region.get_address());
+    auto* header  = new (base) Header();
+    ring->_header = header;
+
+    header->version     = Version;
+    header->slotCount   = slotCount;
+    header->slotsOffset = slotsOffset;
+    header->slotBytes   = slotBytes;
+    header->dataOffset  = dataOffset;
+    header->frameBytes  = frameBytes;
+    header->fps         = fps;
+    for (std::uint32_t i = 0; i < slotCount; i++) {
+        new (base + slotsOffset + i * slotBytes) SlotHeader();
+    }
+
+    // A consumer attaching meanwhile rejects the ring until the magic is set
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(header->magic, Magic, sizeof(Magic));
+    return ring;
+}
+
+std::shared_ptr<SharedFrameRing> SharedFrameRing::attach(
+    const std::string& name)
+{
+    namespace bip = boost::interprocess;
+
+    auto ring = std::make_shared<SharedFrameRing>();
+    try {
+        ring->_shm    = bip::shared_memory_object(bip::open_only,
+                                               name.c_str(),
+                                               bip::read_write);
+        ring->_region = bip::mapped_region(ring->_shm, bip::read_write);
+    } catch (const bip::interprocess_exception&) {
+        return nullptr;
+    }
+    ring->_name = name;
+
+    const std::uint64_t size   = ring->_region.get_size();
+    auto*               header = static_cast<Header*>(
+        ring->_region.get_address());
+    if (size < sizeof(Header) ||
+        std::memcmp(header->magic, Magic, sizeof(Magic)) != 0) {
+        return nullptr;
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (header->version != Version || header->slotCount < 2 ||
+        header->dataOffset < sizeof(SlotHeader) ||
+        header->dataOffset + header->frameBytes > header->slotBytes ||
+        header->slotsOffset < sizeof(Header) ||
+        header->slotsOffset + header->slotBytes * header->slotCount > size) {
+        return nullptr;
+    }
+
+    ring->_header = header;
+    return ring;
+}
+
+SharedFrameRing::~SharedFrameRing()
+{
+    if (_owner) {
+        boost::interprocess::shared_memory_object::remove(_name.c_str());
+    }
+}
+
+bool SharedFrameRing::publish(const cv::Mat& frame, std::int64_t timestampNs)
+{
+    const std::uint64_t rowBytes = frame.cols * frame.elemSize();
+    if (frame.empty() || rowBytes * frame.rows > _header->frameBytes) {
+        _header->dropped++;
+        return false;
+    }
+
+    // Only the producer increments published. Slots a consumer holds are
+    // passed by, their sequence numbers are never published, so a consumer
+    // that does not release its frame (or died holding it) only takes its
+    // slot out of the ring.
+    std::uint64_t sequence = _header->published.load(
+        std::memory_order_relaxed);
+    SlotHeader* s = nullptr;
+    for (std::uint32_t i = 0; i < _header->slotCount; i++, sequence++) {
+        SlotHeader*   candidate = slot(sequence);
+        std::uint32_t state     = candidate->state.load(
+            std::memory_order_acquire);
+        if (state != Reading &&
+            candidate->state.compare_exchange_strong(
+                state, Writing, std::memory_order_acq_rel)) {
+            s = candidate;
+            break;
+        }
+    }
+    if (!s) {
+        _header->dropped++;
+        return false;
+    }
+
+    s->width       = static_cast<std::uint32_t>(frame.cols);
+    s->height      = static_cast<std::uint32_t>(frame.rows);
+    s->type        = static_cast<std::uint32_t>(frame.type());
+    s->step        = rowBytes;
+    s->sequence    = sequence;
+    s->timestampNs = timestampNs;
+
+    char* data = reinterpret_cast<char*>(s) + _header->dataOffset;
+    if (frame.isContinuous()) {
+        std::memcpy(data, frame.data, rowBytes * frame.rows);
+    } else {
+        for (int row = 0; row < frame.rows; row++) {
+            std::memcpy(data + row * rowBytes, frame.ptr(row), rowBytes);
+        }
+    }
+
+    s->state.store(Ready, std::memory_order_release);
+    _header->published.store(sequence + 1, std::memory_order_release);
+    return true;
+}
+
+bool SharedFrameRing::acquire(std::uint64_t& sequence,
+                              cv::Mat&       image,
+                              std::int64_t&  timestampNs)
+{
+    const std::uint64_t slotCount = _header->slotCount;
+
+    // Retried when the producer overwrites the slot while it is pinned, or
+    // passed by the slot of sequence
+    for (std::uint64_t attempt = 0; attempt < slotCount + 4; attempt++) {
+        const std::uint64_t published = this->published();
+        if (sequence >= published) {
+            return false;
+        }
+        // The slot of frame published - slotCount is written next
+        if (published - sequence >= slotCount) {
+            sequence = published - slotCount + 1;
+        }
+
+        SlotHeader*   s        = slot(sequence);
+        std::uint32_t expected = Ready;
+        if (!s->state.compare_exchange_strong(expected,
+                                              Reading,
+                                              std::memory_order_acq_rel)) {
+            // Still pinned with an older frame, the producer skipped it
+            if (expected == Reading) {
+                sequence++;
+            }
+            continue;
+        }
+        if (s->sequence != sequence) {
+            s->state.store(Ready, std::memory_order_release);
+            // Released after the producer skipped it
+            if (s->sequence < sequence) {
+                sequence++;
+            }
+            continue;
+        }
+
+        char*   data = reinterpret_cast<char*>(s) + _header->dataOffset;
+        cv::Mat view(static_cast<int>(s->height),
+                     static_cast<int>(s->width),
+                     static_cast<int>(s->type),
+                     data,
+                     static_cast<size_t>(s->step));
+
+        // Hand the image a reference count of its own, releasing the last
+        // reference unpins the slot
+        auto* u     = new cv::UMatData(SlotAllocator::instance());
+        u->data     = reinterpret_cast<uchar*>(data);
+        u->origdata = u->data;
+        u->size     = s->step * s->height;
+        u->flags |= cv::UMatData::USER_ALLOCATED;
+        u->userdata = new SlotAllocator::Pin{shared_from_this(), s};
+        u->refcount = 1;
+        view.u      = u;
+
+        image       = view;
+        timestampNs = s->timestampNs;
+        return true;
+    }
+    return false;
+}
+
+std::uint64_t SharedFrameRing::published() const
+{
+    return _header->published.load(std::memory_order_acquire);
+}
+
+std::uint64_t SharedFrameRing::dropped() const
+{
+    return _header->dropped.load(std::memory_order_relaxed);
+}
+
+double SharedFrameRing::fps() const
+{
+    return _header->fps;
+}
+
+SharedFrameRing::SlotHeader* SharedFrameRing::slot(
+    std::uint64_t sequence) const
+{
+    char* base = static_cast<char*>(_region.get_address());
+    return reinterpret_cast<SlotHeader*>(
+        base + _header->slotsOffset +
+        (sequence % _header->slotCount) * _header->slotBytes);
+}
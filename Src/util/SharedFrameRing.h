@@ -0,0 +1,135 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/interprocess/shared_memory_object.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+/**
+ * Ring of frames in POSIX shared memory, written by an acquisition process
+ * and read by BioTracker without copying.
+ *
+ * Layout, all fields in native byte order:
+ *
+ *   Header | Slot 0 | Slot 1 | ... | Slot slotCount - 1
+ *
+ * The first slot starts at slotsOffset, on a page boundary, the following
+ * ones are slotBytes apart. A slot is a SlotHeader followed by the rows of the
+ * frame at dataOffset from the slot start, at most frameBytes in total.
+ *
+ * Frame n is written to slot n % slotCount. The producer takes a slot by
+ * switching its state from Empty or Ready to Writing, fills it, sets it to
+ * Ready and only then increments published. The consumer pins the slot of
+ * the frame it wants by switching it from Ready to Reading and checks the
+ * slot's sequence; it switches it back to Ready once the frame is no longer
+ * referenced. A pinned slot is never overwritten: the producer skips it,
+ * publishing the frame with the next sequence number into the next slot, and
+ * the skipped sequence number is never published. Only if all slots are
+ * pinned the producer drops its frame and counts it in dropped.
+ *
+ * A consumer which falls behind by more than slotCount - 1 frames has been
+ * lapped, it continues with the oldest frame still in the ring.
+ */
+class SharedFrameRing : public std::enable_shared_from_this<SharedFrameRing>
+{
+public:
+    static const std::uint32_t Version = 1;
+
+    enum SlotState : std::uint32_t
+    {
+        Empty   = 0,
+        Writing = 1,
+        Ready   = 2,
+        Reading = 3
+    };
+
+    struct Header
+    {
+        char                       magic[8]; // "BTSHMRNG"
+        std::uint32_t              version;
+        std::uint32_t              slotCount;
+        std::uint64_t              slotsOffset;
+        std::uint64_t              slotBytes;
+        std::uint64_t              dataOffset;
+        std::uint64_t              frameBytes;
+        double                     fps; // 0 if unknown
+        std::atomic<std::uint64_t> published;
+        std::atomic<std::uint64_t> dropped;
+    };
+
+    struct SlotHeader
+    {
+        std::atomic<std::uint32_t> state;
+        std::uint32_t              width;
+        std::uint32_t              height;
+        std::uint32_t              type; // OpenCV type, e.g. CV_8UC1
+        std::uint64_t              step; // bytes per row
+        std::uint64_t              sequence;
+        std::int64_t               timestampNs; // monotonic clock
+    };
+
+    /**
+     * Creates the shared memory name for a producer, replacing any previous
+     * one. It is removed again when the returned ring is destroyed.
+     * @return nullptr if the shared memory could not be created.
+     */
+    static std::shared_ptr<SharedFrameRing> create(const std::string& name,
+                                                   std::uint32_t slotCount,
+                                                   std::uint64_t frameBytes,
+                                                   double        fps);
+
+    /**
+     * Attaches a consumer to the shared memory name.
+     * @return nullptr if it does not exist or is no compatible ring.
+     */
+    static std::shared_ptr<SharedFrameRing> attach(const std::string& name);
+
+    ~SharedFrameRing();
+
+    /**
+     * Copies frame into the next slot not held by the consumer and
+     * publishes it.
+     * @return false if the frame was dropped, because it does not fit into a
+     * slot or the consumer holds all slots.
+     */
+    bool publish(const cv::Mat& frame, std::int64_t timestampNs);
+
+    /**
+     * Pins frame sequence, or the oldest frame in the ring if sequence was
+     * overwritten already, or the next one if the producer skipped it. The
+     * returned image references the slot, which stays pinned until the last
+     * copy of the image header is released.
+     * @param sequence the wanted frame, set to the frame actually returned
+     * @return false if the frame has not been published yet.
+     */
+    bool acquire(std::uint64_t& sequence,
+                 cv::Mat&       image,
+                 std::int64_t&  timestampNs);
+
+    /**
+     * Number of frames published so far.
+     */
+    std::uint64_t published() const;
+
+    /**
+     * Number of frames the producer dropped.
+     */
+    std::uint64_t dropped() const;
+
+    double fps() const;
+
+private:
+    class SlotAllocator;
+
+    SlotHeader* slot(std::uint64_t sequence) const;
+
+    std::string                               _name;
+    bool                                      _owner = false;
+    boost::interprocess::shared_memory_object _shm;
+    boost::interprocess::mapped_region        _region;
+    Header*                                   _header = nullptr;
+};
@@ -0,0 +1,72 @@
+#include "Sidecar.h"
+
+#include <cstring>
+#include <sstream>
+
+bool Sidecar::stamp(const boost::filesystem::path& video, Stamp& stamp)
+{
+    boost::system::error_code ec;
+    stamp.size  = boost::filesystem::file_size(video, ec);
+    stamp.mtime = boost::filesystem::last_write_time(video, ec);
+    return !ec;
+}
+
+boost::filesystem::path Sidecar::path(
+    const boost::filesystem::path& video,
+    const boost::filesystem::path& directory,
+    const std::string&             extension)
+{
+    const auto        absolute = boost::filesystem::absolute(video);
+    std::stringstream name;
+    name << absolute.filename().string() << "."
+         << std::hex << std::hash<std::string>()(absolute.string())
+         << extension;
+    return directory / name.str();
+}
+
+bool Sidecar::open(boost::filesystem::ifstream&   in,
+                   const boost::filesystem::path& file,
+                   const Magic&                   magic,
+                   const Stamp&                   stamp)
+{
+    in.open(file, std::ios::binary);
+    char  found[sizeof(Magic)];
+    Stamp written;
+    if (!in || !in.read(found, sizeof(found)) ||
+        std::memcmp(found, magic, sizeof(Magic)) != 0) {
+        return false;
+    }
+    return read(in, written.size) && read(in, written.mtime) &&
+           written == stamp;
+}
+
+bool Sidecar::save(const boost::filesystem::path&            file,
+                   const Magic&                              magic,
+                   const Stamp&                              stamp,
+                   const std::function<void(std::ostream&)>& content)
+{
+    namespace fs = boost::filesystem;
+
+    boost::system::error_code ec;
+    fs::create_directories(file.parent_path(), ec);
+
+    auto temp = file;
+    temp += fs::unique_path(".%%%%%%");
+    {
+        fs::ofstream out(temp, std::ios::binary | std::ios::trunc);
+        out.write(magic, sizeof(Magic));
+        write(out, stamp.size);
+        write(out, stamp.mtime);
+        content(out);
+        if (!out) {
+            fs::remove(temp, ec);
+            return false;
+        }
+    }
+    fs::rename(temp, file, ec);
+    if (ec) {
+        fs::remove(temp, ec);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <ostream>
+#include <string>
+
+/**
+ * Files derived from a video (seek index, motion index, background) stored
+ * in a directory of their own. A sidecar starts with a magic identifying its
+ * format and the stamp of the video it was written for, and is only valid as
+ * long as size and modification time of the video do not change.
+ */
+class Sidecar
+{
+public:
+    using Magic = char[8];
+
+    /**
+     * Size and modification time of a video.
+     */
+    struct Stamp
+    {
+        std::uint64_t size  = 0;
+        std::int64_t  mtime = 0;
+
+        bool operator==(const Stamp& other) const
+        {
+            return size == other.size && mtime == other.mtime;
+        }
+    };
+
+    /**
+     * @return false if video can not be accessed.
+     */
+    static bool stamp(const boost::filesystem::path& video, Stamp& stamp);
+
+    /**
+     * @return the sidecar of video in directory with extension. It is named
+     * after the full path, videos in different directories may share a file
+     * name.
+     */
+    static boost::filesystem::path path(
+        const boost::filesystem::path& video,
+        const boost::filesystem::path& directory,
+        const std::string&             extension);
+
+    /**
+     * Opens file and reads past magic and stamp.
+     * @return false if there is no such file, it has another format or it
+     * was written for another stamp.
+     */
+    static bool open(boost::filesystem::ifstream&   in,
+                     const boost::filesystem::path& file,
+                     const Magic&                   magic,
+                     const Stamp&                   stamp);
+
+    /**
+     * Writes magic and stamp, followed by what content writes. The file is
+     * written under a temporary name and renamed when complete, so that a
+     * concurrent open never sees a partial file.
+     */
+    static bool save(const boost::filesystem::path&            file,
+                     const Magic&                              magic,
+                     const Stamp&                              stamp,
+                     const std::function<void(std::ostream&)>& content);
+
+    template<typename T>
+    static void write(std::ostream& out, const T& value)
+    {
+        out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template<typename T>
+    static bool read(std::istream& in, T& value)
+    {
+        return static_cast<bool>(
+            in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+    }
+};
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+
+/**
+ * Advances capture by stride frames and retrieves only the last one. The
+ * skipped frames are grabbed but never retrieved, so they are not converted
+ * into images.
+ * @param allocator allocates the frame, nullptr for the default allocation
+ * @return the last frame, empty at the end of the stream.
+ */
+inline cv::Mat readStrided(cv::VideoCapture& capture,
+                           std::size_t       stride,
+                           cv::MatAllocator* allocator = nullptr)
+{
+    for (std::size_t i = 1; i < stride; i++) {
+        if (!capture.grab()) {
+            return cv::Mat();
+        }
+    }
+    cv::Mat frame;
+    frame.allocator = allocator;
+    capture.read(frame);
+    return frame;
+}
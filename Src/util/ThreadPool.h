@@ -0,0 +1,96 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Fixed size pool of worker threads executing submitted tasks in FIFO order.
+ * The destructor waits for the queued tasks to finish.
+ */
+class ThreadPool
+{
+public:
+    /**
+     * @param threads number of workers, 0 selects the number of hardware
+     * threads.
+     */
+    explicit ThreadPool(std::size_t threads = 0)
+    {
+        if (threads == 0) {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        for (std::size_t i = 0; i < threads; i++) {
+            _workers.emplace_back([this] { work(); });
+        }
+    }
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _wake.notify_all();
+        for (auto& worker : _workers) {
+            worker.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    std::size_t size() const
+    {
+        return _workers.size();
+    }
+
+    /**
+     * Queues a task.
+     * @return a future holding the task's result.
+     */
+    template<typename F>
+    auto submit(F&& f) -> std::future<decltype(f())>
+    {
+        using Result = decltype(f());
+        auto task    = std::make_shared<std::packaged_task<Result()>>(
+            std::forward<F>(f));
+        auto result = task->get_future();
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _tasks.emplace_back([task] { (*task)(); });
+        }
+        _wake.notify_one();
+        return result;
+    }
+
+private:
+    void work()
+    {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _wake.wait(lock, [this] { return _stop || !_tasks.empty(); });
+                if (_tasks.empty()) {
+                    return;
+                }
+                task = std::move(_tasks.front());
+                _tasks.pop_front();
+            }
+            task();
+        }
+    }
+
+    std::vector<std::thread>          _workers;
+    std::deque<std::function<void()>> _tasks;
+    std::mutex                        _mutex;
+    std::condition_variable           _wake;
+    bool                              _stop = false;
+};
@@ -1,4 +1,5 @@
 #include "VideoCoder.h"
+#include "PixelFormat.h"
 #include <chrono>
 #include <thread>
 
@@ -144,7 +145,8 @@ void Worker::run()
                 return;
 
             cv::Mat writeMat;
-            cv::cvtColor(*(mat->_img),
+            // The encoders take colour frames only
+            cv::cvtColor(convertPixelFormat(*(mat->_img), PixelFormat::BGR),
                          writeMat,
                          CV_BGR2YUV_I420); // CV_BGR2YUV_I420 //CV_BGR2YUV
             int          chans = writeMat.channels();
@@ -165,7 +167,7 @@ void Worker::run()
             if (m_abort)
                 return;
 
-            m_vWriter->write(*mat->_img);
+            m_vWriter->write(convertPixelFormat(*mat->_img, PixelFormat::BGR));
         }
     }
 }
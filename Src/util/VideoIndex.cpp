@@ -0,0 +1,214 @@
+#include "VideoIndex.h"
+
+#include <opencv2/opencv.hpp>
+
+#include <algorithm>
+#include <utility>
+
+namespace
+{
+    const Sidecar::Magic Magic     = {'B', 'T', 'S', 'E', 'E', 'K', '0', '1'};
+    const char*          Extension = ".seekindex";
+
+#if CV_VERSION_MAJOR > 4 || (CV_VERSION_MAJOR == 4 && CV_VERSION_MINOR >= 6)
+    // In raw mode the FFmpeg backend only demuxes and reports the keyframe
+    // flag of each packet, which makes the scan cheap.
+    bool openRaw(cv::VideoCapture& capture, const std::string& filename)
+    {
+        if (capture.open(filename, cv::CAP_FFMPEG) &&
+            capture.set(cv::CAP_PROP_FORMAT, -1)) {
+            return true;
+        }
+        capture.release();
+        return false;
+    }
+
+    bool isKeyframe(cv::VideoCapture& capture)
+    {
+        return capture.get(cv::CAP_PROP_LRF_HAS_KEY_FRAME) != 0;
+    }
+#else
+    bool openRaw(cv::VideoCapture&, const std::string&)
+    {
+        return false;
+    }
+
+    bool isKeyframe(cv::VideoCapture&)
+    {
+        return false;
+    }
+#endif
+}
+
+std::shared_ptr<VideoIndex> VideoIndex::load(
+    const boost::filesystem::path& video,
+    const boost::filesystem::path& directory)
+{
+    auto                        index = std::make_shared<VideoIndex>();
+    boost::filesystem::ifstream in;
+    if (!Sidecar::stamp(video, index->_stamp) ||
+        !Sidecar::open(in,
+                       Sidecar::path(video, directory, Extension),
+                       Magic,
+                       index->_stamp)) {
+        return nullptr;
+    }
+
+    std::uint8_t  keyframes;
+    std::uint64_t frames, anchors;
+    if (!Sidecar::read(in, keyframes) || !Sidecar::read(in, frames) ||
+        !Sidecar::read(in, anchors)) {
+        return nullptr;
+    }
+    if (frames == 0 || anchors == 0 || anchors > frames) {
+        return nullptr;
+    }
+
+    index->_video     = boost::filesystem::absolute(video);
+    index->_keyframes = keyframes != 0;
+    index->_timestamps.resize(frames);
+    in.read(reinterpret_cast<char*>(index->_timestamps.data()),
+            frames * sizeof(double));
+    for (std::uint64_t i = 0; in && i < anchors; i++) {
+        std::uint64_t anchor;
+        if (Sidecar::read(in, anchor) && anchor < frames) {
+            index->_anchors.push_back(anchor);
+        }
+    }
+    if (!in || index->_anchors.size() != anchors) {
+        return nullptr;
+    }
+    return index;
+}
+
+std::shared_ptr<VideoIndex> VideoIndex::build(
+    const boost::filesystem::path& video,
+    const std::atomic<bool>&       abort)
+{
+    auto index    = std::make_shared<VideoIndex>();
+    index->_video = boost::filesystem::absolute(video);
+    if (!Sidecar::stamp(video, index->_stamp)) {
+        return nullptr;
+    }
+
+    cv::VideoCapture capture;
+    index->_keyframes = openRaw(capture, video.string());
+    if (!index->_keyframes && !capture.open(video.string())) {
+        return nullptr;
+    }
+
+    // (timestamp, keyframe) in decoding order
+    std::vector<std::pair<double, bool>> packets;
+    while (!abort && capture.grab()) {
+        packets.emplace_back(capture.get(cv::CAP_PROP_POS_MSEC),
+                             index->_keyframes && isKeyframe(capture));
+    }
+    if (abort || packets.empty()) {
+        return nullptr;
+    }
+
+    // Frames are presented in timestamp order, which differs from the
+    // decoding order for streams with B-frames
+    std::stable_sort(packets.begin(),
+                     packets.end(),
+                     [](const std::pair<double, bool>& a,
+                        const std::pair<double, bool>& b) {
+                         return a.first < b.first;
+                     });
+
+    for (std::size_t i = 0; i < packets.size(); i++) {
+        // Without distinct timestamps a seek cannot be verified
+        if (i > 0 && packets[i].first <= packets[i - 1].first) {
+            return nullptr;
+        }
+        index->_timestamps.push_back(packets[i].first);
+
+        const bool anchor = index->_keyframes
+                                ? packets[i].second
+                                : i % DefaultAnchorInterval == 0;
+        if (anchor) {
+            index->_anchors.push_back(i);
+        }
+    }
+    if (index->_anchors.empty() || index->_anchors.front() != 0) {
+        index->_anchors.insert(index->_anchors.begin(), 0);
+    }
+    return index;
+}
+
+bool VideoIndex::save(const boost::filesystem::path& directory) const
+{
+    return Sidecar::save(
+        Sidecar::path(_video, directory, Extension),
+        Magic,
+        _stamp,
+        [this](std::ostream& out) {
+            Sidecar::write(out, static_cast<std::uint8_t>(_keyframes));
+            Sidecar::write(out,
+                           static_cast<std::uint64_t>(_timestamps.size()));
+            Sidecar::write(out, static_cast<std::uint64_t>(_anchors.size()));
+            out.write(reinterpret_cast<const char*>(_timestamps.data()),
+                      _timestamps.size() * sizeof(double));
+            for (auto anchor : _anchors) {
+                Sidecar::write(out, static_cast<std::uint64_t>(anchor));
+            }
+        });
+}
+
+bool VideoIndex::saveUnindexable(const boost::filesystem::path& video,
+                                 const boost::filesystem::path& directory)
+{
+    Sidecar::Stamp stamp;
+    if (!Sidecar::stamp(video, stamp)) {
+        return false;
+    }
+    // An index without frames, which load() rejects
+    return Sidecar::save(Sidecar::path(video, directory, Extension),
+                         Magic,
+                         stamp,
+                         [](std::ostream& out) {
+                             Sidecar::write(out, std::uint8_t(0));
+                             Sidecar::write(out, std::uint64_t(0));
+                             Sidecar::write(out, std::uint64_t(0));
+                         });
+}
+
+bool VideoIndex::unindexable(const boost::filesystem::path& video,
+                             const boost::filesystem::path& directory)
+{
+    Sidecar::Stamp              stamp;
+    boost::filesystem::ifstream in;
+    std::uint8_t                keyframes;
+    std::uint64_t               frames;
+    return Sidecar::stamp(video, stamp) &&
+           Sidecar::open(in,
+                         Sidecar::path(video, directory, Extension),
+                         Magic,
+                         stamp) &&
+           Sidecar::read(in, keyframes) && Sidecar::read(in, frames) &&
+           frames == 0;
+}
+
+std::size_t VideoIndex::frameAt(double msec) const
+{
+    auto it = std::lower_bound(_timestamps.begin(), _timestamps.end(), msec);
+    if (it == _timestamps.end()) {
+        return _timestamps.size() - 1;
+    }
+    if (it != _timestamps.begin() && msec - *(it - 1) < *it - msec) {
+        --it;
+    }
+    return static_cast<std::size_t>(it - _timestamps.begin());
+}
+
+std::size_t VideoIndex::anchorBefore(std::size_t frame) const
+{
+    auto it = std::upper_bound(_anchors.begin(), _anchors.end(), frame);
+    return it == _anchors.begin() ? 0 : *(it - 1);
+}
+
+std::size_t VideoIndex::anchorAfter(std::size_t frame) const
+{
+    auto it = std::upper_bound(_anchors.begin(), _anchors.end(), frame);
+    return it == _anchors.end() ? frameCount() : *it;
+}
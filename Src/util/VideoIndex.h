@@ -0,0 +1,106 @@
+#pragma once
+
+#include "Sidecar.h"
+
+#include <boost/filesystem.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * Seek index of a video file: the exact number of frames, the presentation
+ * timestamp of every frame and the frames a seek can start decoding from.
+ *
+ * Building the index requires a full scan of the file, so it is stored as a
+ * sidecar and reused as long as size and modification time of the video do
+ * not change.
+ */
+class VideoIndex
+{
+public:
+    /**
+     * Anchor distance used when the backend does not report keyframes.
+     */
+    static const std::size_t DefaultAnchorInterval = 250;
+
+    /**
+     * @return the index stored for video in directory, or nullptr if there
+     * is none or it is outdated.
+     */
+    static std::shared_ptr<VideoIndex> load(
+        const boost::filesystem::path& video,
+        const boost::filesystem::path& directory);
+
+    /**
+     * Scans the whole video. Returns nullptr if the scan was aborted or the
+     * video could not be read.
+     */
+    static std::shared_ptr<VideoIndex> build(
+        const boost::filesystem::path& video,
+        const std::atomic<bool>&       abort);
+
+    /**
+     * Writes the index as sidecar for its video into directory.
+     */
+    bool save(const boost::filesystem::path& directory) const;
+
+    /**
+     * Records in directory that video can not be indexed, e.g. because its
+     * timestamps are not distinct, so that it is not scanned again as long
+     * as it does not change.
+     */
+    static bool saveUnindexable(const boost::filesystem::path& video,
+                                const boost::filesystem::path& directory);
+
+    /**
+     * @return true if saveUnindexable() was called for video as it is now.
+     */
+    static bool unindexable(const boost::filesystem::path& video,
+                            const boost::filesystem::path& directory);
+
+    std::size_t frameCount() const
+    {
+        return _timestamps.size();
+    }
+
+    /**
+     * @return presentation timestamp of frame in milliseconds.
+     */
+    double timestamp(std::size_t frame) const
+    {
+        return _timestamps[frame];
+    }
+
+    /**
+     * @return the frame whose timestamp is closest to msec.
+     */
+    std::size_t frameAt(double msec) const;
+
+    /**
+     * @return the last anchor (keyframe) at or before frame.
+     */
+    std::size_t anchorBefore(std::size_t frame) const;
+
+    /**
+     * @return the first anchor after frame, frameCount() if there is none.
+     */
+    std::size_t anchorAfter(std::size_t frame) const;
+
+    /**
+     * True if the anchors are the keyframes of the stream, false if they are
+     * spaced evenly.
+     */
+    bool hasKeyframes() const
+    {
+        return _keyframes;
+    }
+
+private:
+    boost::filesystem::path  _video;
+    Sidecar::Stamp           _stamp;
+    bool                     _keyframes = false;
+    std::vector<double>      _timestamps;
+    std::vector<std::size_t> _anchors;
+};
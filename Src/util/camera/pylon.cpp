@@ -15,7 +15,7 @@ Pylon::IPylonDevice* getPylonDevice(int index)
     throw std::out_of_range("No such Pylon camera available");
 }
 
-cv::Mat toOpenCV(Pylon::CGrabResultPtr image)
+cv::Mat toOpenCV(Pylon::CGrabResultPtr image, PixelFormat format)
 {
     auto size = cv::Size{static_cast<int>(image->GetWidth()),
                          static_cast<int>(image->GetHeight())};
@@ -24,12 +24,18 @@ cv::Mat toOpenCV(Pylon::CGrabResultPtr image)
     switch (image->GetPixelType()) {
     case Pylon::PixelType_Mono8: {
         auto mat = cv::Mat{size, CV_8UC1, data};
-        cv::cvtColor(mat, mat, cv::COLOR_GRAY2BGR);
+        if (format == PixelFormat::BGR) {
+            cv::cvtColor(mat, mat, cv::COLOR_GRAY2BGR);
+        }
         return mat;
     }
     case Pylon::PixelType_BayerBG8: {
         auto mat = cv::Mat{size, CV_8UC1, data};
-        cv::cvtColor(mat, mat, cv::COLOR_BayerBG2BGR_EA);
+        if (format == PixelFormat::BGR) {
+            cv::cvtColor(mat, mat, cv::COLOR_BayerBG2BGR_EA);
+        } else if (format == PixelFormat::Gray8) {
+            cv::cvtColor(mat, mat, cv::COLOR_BayerBG2GRAY);
+        }
         return mat;
     }
     default:
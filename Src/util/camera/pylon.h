@@ -3,11 +3,12 @@
 #if HAS_PYLON
 
     #include "util/camera/base.h"
+    #include "util/PixelFormat.h"
 
     #include <opencv2/core/mat.hpp>
     #include <pylon/PylonIncludes.h>
 
 Pylon::IPylonDevice* getPylonDevice(int index);
-cv::Mat              toOpenCV(Pylon::CGrabResultPtr image);
+cv::Mat toOpenCV(Pylon::CGrabResultPtr image, PixelFormat format);
 
 #endif